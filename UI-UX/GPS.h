@@ -10,7 +10,17 @@
 
 enum AlgorithmType {
     DIJKSTRA,
-    ASTAR
+    ASTAR,
+    JPS,
+    JPS_PLUS,
+    HPA,
+    DSTAR_LITE,
+    FLOW_FIELD,
+    ALT,
+    CH,
+    ARA,
+    SPACE_TIME,
+    FIRST_MOVE
 };
 
 class GPS {
@@ -23,11 +33,21 @@ class GPS {
     float glowDirection;
 
     bool showingComparison = false;
+
+    // A search still running: a dashed line to the tile it has got closest to
+    bool searching = false;
+    std::vector<sf::Vector2i> searchProbe;
+    sf::Vector2i searchGoal;
+
+    // Other NaviGators walking with a cooperative plan, drawn as dots
+    std::vector<sf::Vector2i> agents;
 public:
     GPS();
 
     void setPath(const std::vector<sf::Vector2i>& newPath, AlgorithmType algo);
     void setComparisonPaths(const std::vector<sf::Vector2i>& dPath, const std::vector<sf::Vector2i>& aPath);
+    void setSearching(const std::vector<sf::Vector2i>& probe, sf::Vector2i goal);
+    void setAgents(const std::vector<sf::Vector2i>& positions);
     void update(float deltaTime);
     void draw(sf::RenderWindow& window);
     void clearPath();
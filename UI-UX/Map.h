@@ -25,6 +25,9 @@ class Map {
     unsigned tilesetFirstGID;
     int tileWidth;
     int tileHeight;
+
+    // Tiled editor chunk size, reused as the cluster size for hierarchical pathfinding
+    sf::Vector2i chunkSize{64, 64};
     
     // Lava generator
     LavaGenerator* lavaGenerator;
@@ -34,6 +37,28 @@ class Map {
     std::unordered_map<sf::Vector2i, bool, Vector2iHash> walkableMap;
 
     sf::Texture lavaTexture;
+    sf::Sprite lavaSprite;
+
+    // Spreading lava, grows outward every few seconds
+    std::vector<sf::Vector2i> lavaTiles;
+    float lavaTimer = 0.f;
+    unsigned lavaTick = 0; // spread ticks so far, counted even when nothing was left to spread to
+
+    // Flat lava lookup (generator lava + spreading lava), indexed y * width + x
+    std::vector<unsigned char> lavaGrid;
+
+    // Bumped whenever any tile changes, so pathfinders know when to resync
+    unsigned version = 0;
+
+    // Bumped only when the lava is regenerated. Between two bumps lava only spreads,
+    // so tiles close but never reopen.
+    unsigned layout = 0;
+
+    // Tiles the last spread tick turned to lava, so pathfinders can patch instead of rebuilding
+    std::vector<sf::Vector2i> lastLavaChanges;
+    bool lastChangeWasSpread = false;
+
+    void rebuildLavaGrid();
 
 public:
     Map();
@@ -48,6 +73,18 @@ public:
     
     // Generate lava
     void generateLava();
+
+    // Scatter spreading lava seeds and grow each one a little
+    void generateSpreadingLava(int seedCount, int initialLavaPerSeed);
+    const std::vector<sf::Vector2i>& getLavaTiles() const;
+
+    // Spread lava one step every 3 seconds
+    static constexpr float lavaSpreadInterval = 3.0f;
+    void updateLavaSpread(float deltaTime);
+
+    // Spread ticks so far, and seconds since the last one, for forecasting the lava
+    unsigned getLavaTick() const;
+    float getLavaTimer() const;
     
     // Set lava generation parameters
     void setLavaFrequency(float freq);
@@ -65,6 +102,17 @@ public:
 
     int getWidth() const;
     int getHeight() const;
+    sf::Vector2i getChunkSize() const;
+
+    // Raw lava grid and its version, for pathfinders that keep their own copy
+    const std::vector<unsigned char>& getLavaGrid() const;
+    unsigned getVersion() const;
+    unsigned getLayout() const;
+
+    // Tiles that turned to lava in the last spread tick. Only meaningful when
+    // wasLastChangeSpread() is true; a regeneration can change any tile.
+    const std::vector<sf::Vector2i>& getLastLavaChanges() const;
+    bool wasLastChangeSpread() const;
     
     // Convert between screen and tile coordinates
     sf::Vector2f tileToScreen(int x, int y) const;
@@ -33,6 +33,7 @@ public:
     void draw(sf::RenderWindow &window);
     void setScale(const sf::Vector2f &scale);
     sf::Vector2f getPosition() const;
+    float getTilesPerSecond() const;
 
 };
 
@@ -16,9 +16,11 @@ class UX {
     sf::Text instructionText;
     sf::Text inputText;
     sf::Text coordConfirmText;
+    sf::Text statsText;
 
     sf::RectangleShape inputBox;
     sf::RectangleShape confirmBackground;
+    sf::RectangleShape statsBackground;
     sf::RectangleShape cursor;
 
     std::string typedCoords;
@@ -48,6 +50,10 @@ public:
     void setConfirmationMessage(const std::string& message);
     void clearConfirmationMessage();
 
+    // Counters of the last search, shown under the confirmation message
+    void setSearchStats(const std::string& stats);
+    void clearSearchStats();
+
     sf::Vector2i getTypedCoordinates() const;
 
 };
@@ -12,6 +12,7 @@ void GPS::setPath(const std::vector<sf::Vector2i>& newPath, AlgorithmType algo)
     path = newPath;
     currentAlgo = algo;
     showingComparison = false;
+    searching = false;
 }
 
 
@@ -22,6 +23,18 @@ void GPS::setComparisonPaths(const std::vector<sf::Vector2i>& dPath, const std::
     dijkstraPath = dPath;
     astarPath = aPath;
     showingComparison = true;
+    searching = false;
+}
+
+void GPS::setSearching(const std::vector<sf::Vector2i>& probe, sf::Vector2i goal) {
+    searchProbe = probe;
+    searchGoal = goal;
+    searching = true;
+    showingComparison = false;
+}
+
+void GPS::setAgents(const std::vector<sf::Vector2i>& positions) {
+    agents = positions;
 }
 
 void GPS::update(float deltaTime) {
@@ -36,6 +49,15 @@ void GPS::update(float deltaTime) {
 }
 
 void GPS::draw(sf::RenderWindow& window) {
+    // Each agent keeps its own hue so it can be followed through the crowd
+    for (size_t i = 0; i < agents.size(); ++i) {
+        sf::CircleShape dot(3.f);
+        dot.setFillColor(sf::Color(90 + (i * 67) % 166, 90 + (i * 131) % 166, 90 + (i * 193) % 166));
+        dot.setOrigin(3.f, 3.f);
+        dot.setPosition((agents[i].x - agents[i].y) * 16.f, (agents[i].x + agents[i].y) * 8.f);
+        window.draw(dot);
+    }
+
     if (showingComparison) {
         auto drawPath = [&](const std::vector<sf::Vector2i>& path, sf::Color color) {
             for (size_t i = 1; i < path.size(); ++i) {
@@ -80,11 +102,67 @@ void GPS::draw(sf::RenderWindow& window) {
         return;
     }
 
+    if (searching) {
+        // Every other segment, pulsing, so it can't be mistaken for a finished path
+        sf::Color dashColor(255, 255, 255, static_cast<sf::Uint8>(glowAlpha));
+        for (size_t i = 1; i < searchProbe.size(); i += 2) {
+            sf::Vector2i a = searchProbe[i - 1];
+            sf::Vector2i b = searchProbe[i];
+
+            float ax = (a.x - a.y) * 16.f;
+            float ay = (a.x + a.y) * 8.f;
+            float bx = (b.x - b.y) * 16.f;
+            float by = (b.x + b.y) * 8.f;
+
+            sf::Vector2f dir(bx - ax, by - ay);
+            float length = std::sqrt(dir.x * dir.x + dir.y * dir.y);
+            float rotation = std::atan2(dir.y, dir.x) * 180.f / 3.14159f;
+
+            sf::RectangleShape segment(sf::Vector2f(length, 4.f));
+            segment.setFillColor(dashColor);
+            segment.setOrigin(0, 2.f);
+            segment.setPosition(ax, ay);
+            segment.setRotation(rotation);
+            window.draw(segment);
+        }
+
+        if (!searchProbe.empty()) {
+            sf::CircleShape startMarker(6.f);
+            startMarker.setFillColor(sf::Color::Red);
+            startMarker.setOrigin(6.f, 6.f);
+            startMarker.setPosition((searchProbe.front().x - searchProbe.front().y) * 16.f,
+                                    (searchProbe.front().x + searchProbe.front().y) * 8.f);
+            window.draw(startMarker);
+        }
+
+        sf::CircleShape endMarker(6.f);
+        endMarker.setFillColor(sf::Color::Transparent);
+        endMarker.setOutlineColor(sf::Color::Yellow);
+        endMarker.setOutlineThickness(2.f);
+        endMarker.setOrigin(6.f, 6.f);
+        endMarker.setPosition((searchGoal.x - searchGoal.y) * 16.f, (searchGoal.x + searchGoal.y) * 8.f);
+        window.draw(endMarker);
+        return;
+    }
+
     if (path.empty()) return;
 
-    sf::Color pathColor = (currentAlgo == DIJKSTRA)
-        ? sf::Color(50, 170, 255, static_cast<sf::Uint8>(glowAlpha))
-        : sf::Color(0, 255, 150, static_cast<sf::Uint8>(glowAlpha));
+    sf::Color pathColor;
+    switch (currentAlgo) {
+        case DIJKSTRA: pathColor = sf::Color(50, 170, 255); break;  // blue
+        case ASTAR:    pathColor = sf::Color(0, 255, 150); break;   // green
+        case JPS:      pathColor = sf::Color(255, 190, 40); break;  // orange
+        case JPS_PLUS: pathColor = sf::Color(200, 90, 255); break;  // purple
+        case HPA:      pathColor = sf::Color(255, 90, 170); break;  // pink
+        case DSTAR_LITE: pathColor = sf::Color(255, 255, 90); break; // yellow
+        case FLOW_FIELD: pathColor = sf::Color(90, 230, 255); break; // cyan
+        case ALT:      pathColor = sf::Color(180, 255, 80); break;  // lime
+        case CH:       pathColor = sf::Color(255, 120, 90); break;  // coral
+        case ARA:      pathColor = sf::Color(240, 240, 240); break; // white
+        case SPACE_TIME: pathColor = sf::Color(170, 150, 255); break; // lavender
+        case FIRST_MOVE: pathColor = sf::Color(255, 175, 60); break;  // amber
+    }
+    pathColor.a = static_cast<sf::Uint8>(glowAlpha);
 
     for (size_t i = 1; i < path.size(); ++i) {
         sf::Vector2i a = path[i - 1];
@@ -141,4 +219,5 @@ void GPS::clearPath() {
     dijkstraPath.clear();
     astarPath.clear();
     showingComparison = false;
+    searching = false;
 }
@@ -1,6 +1,9 @@
 #include "Map.h"
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
 
 using namespace tinyxml2;
 
@@ -29,6 +32,13 @@ bool Map::loadFromFile(const std::string& tmxFilePath, int tw, int th) {
   int width = mapElement->IntAttribute("width");
   int height = mapElement->IntAttribute("height");
 
+  if (XMLElement* settings = mapElement->FirstChildElement("editorsettings")) {
+      if (XMLElement* chunk = settings->FirstChildElement("chunksize")) {
+          chunkSize.x = chunk->IntAttribute("width", 64);
+          chunkSize.y = chunk->IntAttribute("height", 64);
+      }
+  }
+
     if (!parseTilesets(mapElement)) return false;
     if (!parseLayers(mapElement, width, height)) return false;
     if (!lavaTexture.loadFromFile("sprites/lava-1.png")) {
@@ -233,6 +243,10 @@ int Map::getHeight() const {
   return layers.empty() ? 0 : layers[0].height;
 }
 
+sf::Vector2i Map::getChunkSize() const {
+  return chunkSize;
+}
+
 void Map::generateSpreadingLava(int seedCount, int initialLavaPerSeed) {
     lavaTiles.clear();
     std::srand(static_cast<unsigned>(std::time(nullptr)));
@@ -278,6 +292,8 @@ void Map::generateSpreadingLava(int seedCount, int initialLavaPerSeed) {
             }
         }
     }
+
+    rebuildLavaGrid();
 }
 
 Map::~Map() {
@@ -296,6 +312,30 @@ void Map::generateLava() {
     if (lavaGenerator) {
         lavaGenerator->generate();
     }
+    rebuildLavaGrid();
+}
+
+// Bake generator lava and spreading lava into one flat grid so isLava is a single index
+void Map::rebuildLavaGrid() {
+    int w = getWidth();
+    int h = getHeight();
+    lavaGrid.assign(static_cast<size_t>(w) * h, 0);
+
+    if (lavaGenerator) {
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                if (lavaGenerator->isLava(x, y)) lavaGrid[y * w + x] = 1;
+            }
+        }
+    }
+    for (const auto& tile : lavaTiles) {
+        if (tile.x >= 0 && tile.y >= 0 && tile.x < w && tile.y < h)
+            lavaGrid[tile.y * w + tile.x] = 1;
+    }
+    lastLavaChanges.clear();
+    lastChangeWasSpread = false;
+    ++version;
+    ++layout;
 }
 
 // Lava parameter setters
@@ -314,7 +354,9 @@ void Map::setLavaOctaves(int oct) {
 
 // isLava
 bool Map::isLava(int x, int y) const {
-    return lavaGenerator && lavaGenerator->isLava(x, y);
+    int w = getWidth();
+    if (x < 0 || y < 0 || x >= w || y >= getHeight() || lavaGrid.empty()) return false;
+    return lavaGrid[y * w + x] != 0;
 }
 
 // isWalkable
@@ -338,9 +380,32 @@ sf::Vector2f Map::tileToScreen(int x, int y) const {
     return sf::Vector2f(screenX, screenY);
 }
 
+const std::vector<unsigned char>& Map::getLavaGrid() const {
+    return lavaGrid;
+}
 
-bool Map::isLava(int x, int y) const {
-    return std::find(lavaTiles.begin(), lavaTiles.end(), sf::Vector2i(x, y)) != lavaTiles.end();
+unsigned Map::getVersion() const {
+    return version;
+}
+
+unsigned Map::getLayout() const {
+    return layout;
+}
+
+const std::vector<sf::Vector2i>& Map::getLastLavaChanges() const {
+    return lastLavaChanges;
+}
+
+unsigned Map::getLavaTick() const {
+    return lavaTick;
+}
+
+float Map::getLavaTimer() const {
+    return lavaTimer;
+}
+
+bool Map::wasLastChangeSpread() const {
+    return lastChangeWasSpread;
 }
 
 const std::vector<sf::Vector2i>& Map::getLavaTiles() const {
@@ -350,8 +415,9 @@ const std::vector<sf::Vector2i>& Map::getLavaTiles() const {
 void Map::updateLavaSpread(float deltaTime) {
     lavaTimer += deltaTime;
 
-    if (lavaTimer < 3.0f) return;
+    if (lavaTimer < lavaSpreadInterval) return;
     lavaTimer = 0.0f;
+    ++lavaTick;
 
     int w = getWidth();
     int h = getHeight();
@@ -381,7 +447,16 @@ void Map::updateLavaSpread(float deltaTime) {
         if (added >= maxNewTiles) break;
     }
 
+    if (newLava.empty()) return;
+
+    lastLavaChanges.clear();
     for (const auto& tile : newLava) {
+        // Two lava tiles can spread into the same neighbour in one tick
+        if (lavaGrid[tile.y * w + tile.x]) continue;
+        lavaGrid[tile.y * w + tile.x] = 1;
         lavaTiles.push_back(tile);
+        lastLavaChanges.push_back(tile);
     }
+    lastChangeWasSpread = true;
+    ++version;
 }
@@ -94,6 +94,11 @@ sf::Vector2f NaviGator::getPosition() const {
     return navigatorSprite.getPosition();
 }
 
+// Each key moves half a tile width and height per unit of speed, i.e. one tile along that axis
+float NaviGator::getTilesPerSecond() const {
+    return navigatorSpeed;
+}
+
 void NaviGator::updateFrame() {
     currentFrame = (currentFrame + 1) % frames.size();
     navigatorSprite.setTextureRect(frames[currentFrame]);
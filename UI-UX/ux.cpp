@@ -60,6 +60,11 @@ UX::UX(const string& message) {
     coordConfirmText.setCharacterSize(18);
     coordConfirmText.setFillColor(sf::Color(30, 30, 30));
     coordConfirmText.setPosition(10.f, 180.f);
+
+    statsText.setFont(font);
+    statsText.setCharacterSize(16);
+    statsText.setFillColor(sf::Color(30, 30, 30));
+    statsBackground.setFillColor(sf::Color(255, 255, 255, 150));
 }
 
 void UX::setMessage(const string &message) {
@@ -120,6 +125,18 @@ void UX::draw(sf::RenderWindow &window) {
         window.draw(confirmBackground);
         window.draw(coordConfirmText);
     }
+    if (!statsText.getString().isEmpty()) {
+        // Below the confirmation box, wherever its last message left it
+        float padding = 10.f;
+        float top = coordMessage.empty() ? 200.f : confirmBackground.getPosition().y + confirmBackground.getSize().y + padding;
+        sf::FloatRect bounds = statsText.getLocalBounds();
+        statsText.setOrigin(bounds.left, bounds.top);
+        statsText.setPosition(10.f + padding, top + padding);
+        statsBackground.setSize(sf::Vector2f(bounds.width + 2 * padding, bounds.height + 2 * padding));
+        statsBackground.setPosition(10.f, top);
+        window.draw(statsBackground);
+        window.draw(statsText);
+    }
 
 }
 
@@ -194,3 +211,11 @@ void UX::clearConfirmationMessage() {
     coordConfirmText.setString("");
     confirmBackground.setSize(sf::Vector2f(0, 0));
 }
+
+void UX::setSearchStats(const std::string& stats) {
+    statsText.setString(stats);
+}
+
+void UX::clearSearchStats() {
+    statsText.setString("");
+}
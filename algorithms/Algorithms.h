@@ -7,10 +7,11 @@
 
 #include <vector>
 #include <SFML/System.hpp>
+#include "SearchResult.h"
 #include "../UI-UX/Map.h"
 using namespace std;
 
-vector<sf::Vector2i> findDijkstraPath(const Map& map, sf::Vector2i start, sf::Vector2i goal);
-vector<sf::Vector2i> findAStarPath(const Map& map, sf::Vector2i start, sf::Vector2i goal);
+SearchResult findDijkstraPath(const Map& map, sf::Vector2i start, sf::Vector2i goal);
+SearchResult findAStarPath(const Map& map, sf::Vector2i start, sf::Vector2i goal);
 
 #endif
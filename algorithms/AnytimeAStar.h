@@ -0,0 +1,72 @@
+#ifndef ANYTIMEASTAR_H
+#define ANYTIMEASTAR_H
+
+#include <chrono>
+#include <utility>
+#include <vector>
+#include <SFML/System.hpp>
+#include "SearchGrid.h"
+#include "SearchWorkspace.h"
+#include "SearchResult.h"
+#include "../UI-UX/Map.h"
+
+// Anytime Repairing A* (ARA*). Starts as weighted A*, f = g + w * h, which finds a path
+// at most w times the shortest one quickly. Each later pass lowers w and reuses the
+// costs found so far: only tiles whose cost improved after they were expanded
+// (the INCONS list) go back on the open list. Work is done in time slices, so a
+// frame never waits for more than its budget.
+class AnytimeAStar {
+    SearchGrid grid;
+    SearchWorkspace costs;                  // g and parent of every tile reached so far
+    std::vector<unsigned> closedIn;         // pass a tile was expanded in
+    std::vector<unsigned> inconsIn;         // pass a tile was put on INCONS in
+    std::vector<int> incons;                // expanded this pass, then reached more cheaply
+    std::vector<std::pair<int, int>> open;  // (10 * g + weight * h, tile) min-heap with lazy deletion
+    unsigned pass = 0;
+
+    sf::Vector2i start;
+    sf::Vector2i goal;
+    int startIndex = 0;
+    int goalIndex = 0;
+    int initialWeight = 30;                 // tenths, so 30 means w = 3.0
+    int weight = 30;
+    bool active = false;
+    bool finished = false;
+
+    std::vector<sf::Vector2i> path;         // best path published so far
+    double bound = 0;                       // path is at most this many times the shortest
+    SearchStats stats;                      // summed over every slice since plan()
+
+    enum class PassResult { Solved, OutOfTime, Exhausted };
+
+    int heuristic(int tile) const;
+    int keyOf(int tile) const { return 10 * costs.costOf(tile) + weight * heuristic(tile); }
+    void push(int tile);
+    void beginPass();
+    PassResult improvePath(std::chrono::steady_clock::time_point deadline);
+    void publish();
+
+public:
+    // Plan from scratch. initialWeight is in tenths (30 = paths at most 3x the shortest).
+    void plan(const Map& map, sf::Vector2i from, sf::Vector2i destination, int initialWeight = 30);
+    void clear() { active = false; }
+
+    // Searching or holding a path
+    bool isActive() const { return active; }
+    // The shortest path has been found, or the destination was unreachable
+    bool isFinished() const { return finished; }
+
+    // Feed this tick's lava. Starts again from the NaviGator's tile when lava lands on the
+    // published path, or on a tile the search still relies on. Returns true if it started over.
+    bool sync(const Map& map, sf::Vector2i from);
+
+    // Search for at most budget. Returns true if a better path was found.
+    bool step(std::chrono::microseconds budget);
+
+    const std::vector<sf::Vector2i>& getPath() const { return path; }
+    double getBound() const { return bound; }
+    double getWeight() const { return weight / 10.0; }
+    const SearchStats& getStats() const { return stats; }
+};
+
+#endif //ANYTIMEASTAR_H
@@ -0,0 +1,45 @@
+#ifndef BATCHPATHFINDER_H
+#define BATCHPATHFINDER_H
+
+#include <vector>
+#include <SFML/System.hpp>
+#include "Pathfinder.h"
+#include "SearchGrid.h"
+#include "ThreadPool.h"
+#include "../UI-UX/Map.h"
+
+struct BatchQuery {
+    sf::Vector2i start;
+    sf::Vector2i goal;
+};
+
+struct BatchResult {
+    std::vector<sf::Vector2i> path; // empty if there is no path
+    int nodesExplored = 0;
+    float searchUs = 0;
+};
+
+// Answers many (start, goal) queries against one map state at once, spread over a
+// thread pool. Each thread searches with its own long-lived Pathfinder, so no search
+// state is allocated per query and threads never share a workspace.
+class BatchPathfinder {
+    ThreadPool pool;
+    std::vector<Pathfinder> pathfinders; // one per pool thread
+    SearchGrid grid;
+
+public:
+    // threadCount 0 means one thread per core
+    explicit BatchPathfinder(unsigned threadCount = 0);
+
+    unsigned getThreadCount() const { return pool.size(); }
+
+    // A* for queries[0 .. count), results in the same order
+    std::vector<BatchResult> findAStarPaths(const Map& map, const BatchQuery* queries, size_t count);
+    std::vector<BatchResult> findAStarPaths(const SearchGrid& searchGrid, const BatchQuery* queries, size_t count);
+
+    std::vector<BatchResult> findAStarPaths(const SearchGrid& searchGrid, const std::vector<BatchQuery>& queries) {
+        return findAStarPaths(searchGrid, queries.data(), queries.size());
+    }
+};
+
+#endif //BATCHPATHFINDER_H
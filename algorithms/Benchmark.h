@@ -0,0 +1,17 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "../UI-UX/Map.h"
+
+struct FirstMoveTable;
+
+// Times every pathfinder on the same random walkable (start, goal) pairs over the
+// current map and prints a table to cout. Bound to the B key in main.cpp. The first-move
+// table takes minutes to build, so it is only timed if one is passed in.
+void runPathBenchmark(const Map& map, int queryCount = 20, unsigned seed = 77, const FirstMoveTable* firstMoves = nullptr);
+
+// How parallel A* scales from one thread to one per core, against plain A*, on a synthetic
+// size x size lava map much bigger than the game's. Bound to Shift+B in main.cpp.
+void runParallelSearchBenchmark(int size = 4096, int queryCount = 5, unsigned seed = 77);
+
+#endif //BENCHMARK_H
@@ -0,0 +1,56 @@
+#ifndef BITPARALLELBFS_H
+#define BITPARALLELBFS_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <SFML/System.hpp>
+#include "SearchGrid.h"
+#include "../UI-UX/Map.h"
+
+// Breadth-first search that grows the whole frontier a layer at a time, 64 tiles per
+// word: next = (frontier shifted left/right/up/down) & walkable & ~visited. Each layer
+// is kept, so the path is walked back from the goal by stepping to any neighbour that
+// sits in the layer before. Only valid while every step costs 1.
+// Built with AVX2 (-DLAVA_AVX2=ON in CMake) it handles four words per instruction.
+class BitParallelBfs {
+    // Row bitsets with a zero word on each side of every row and a zero row above and
+    // below the map, so the shifts never need bounds checks
+    SearchGrid grid;                // kept in step with the Map by the Map overload
+    int width = 0;
+    int height = 0;
+    unsigned packedVersion = ~0u;   // Map version the bitsets were packed from
+    int wordsPerRow = 0;
+    int stride = 0;                 // words per padded row, a multiple of 4 plus the two pads
+    std::vector<uint64_t> walk;
+    std::vector<uint64_t> visited;
+    std::vector<uint64_t> frontier;
+    std::vector<uint64_t> next;
+    std::vector<int> frontierRows;  // padded rows holding any frontier bit, ascending
+    std::vector<int> nextRows;
+
+    // Every frontier of the last search. A frontier is thin, so only its non-zero words
+    // are kept, as (word index, bits) in ascending order; layerStart[k] is where layer k begins.
+    bool keepLayers = false;
+    std::vector<size_t> layerStart;
+    std::vector<std::pair<size_t, uint64_t>> layerWords;
+
+    int nodesExplored = 0;
+
+    void pack(const SearchGrid& searchGrid);
+    void begin(int sourceIndex);
+    bool grow();
+    bool inLayer(int layer, int x, int y) const;
+
+public:
+    std::vector<sf::Vector2i> findPath(const Map& map, sf::Vector2i start, sf::Vector2i goal);
+    std::vector<sf::Vector2i> findPath(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal);
+
+    // Steps from source to every tile, -1 where lava blocks the way
+    void distancesFrom(const SearchGrid& searchGrid, sf::Vector2i source, std::vector<int>& distances);
+
+    // Tiles reached by the last search
+    int getNodesExplored() const { return nodesExplored; }
+};
+
+#endif //BITPARALLELBFS_H
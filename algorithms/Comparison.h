@@ -0,0 +1,44 @@
+#ifndef COMPARISON_H
+#define COMPARISON_H
+
+#include <future>
+#include <memory>
+#include <vector>
+#include <SFML/System.hpp>
+#include "SearchGrid.h"
+#include "SearchResult.h"
+
+struct ComparisonResult {
+    sf::Vector2i start;
+    sf::Vector2i goal;
+    unsigned layout = 0; // Map layout of the snapshot that was searched
+    std::vector<sf::Vector2i> dijkstraPath;
+    std::vector<sf::Vector2i> astarPath;
+    SearchStats dijkstraStats;
+    SearchStats astarStats;
+};
+
+// Runs Compare mode's searches on worker threads so the frame loop keeps rendering.
+// All workers read the same immutable snapshot of the grid, each with its own workspace.
+class Comparison {
+    std::future<SearchResult> dijkstra;
+    std::future<SearchResult> astar;
+    bool discarded = false;
+    sf::Vector2i searchedFrom;
+    sf::Vector2i searchedTo;
+    unsigned searchedLayout = 0;
+
+public:
+    // Starts the searches; ignored (returns false) while a previous comparison is still running
+    bool start(std::shared_ptr<const SearchGrid> snapshot, sf::Vector2i from, sf::Vector2i to);
+
+    bool isRunning() const { return dijkstra.valid(); }
+
+    // Drop the running comparison's results when they arrive (e.g. after pressing R)
+    void discard() { discarded = isRunning(); }
+
+    // True once every search has finished and the results weren't discarded; fills result
+    bool poll(ComparisonResult& result);
+};
+
+#endif //COMPARISON_H
@@ -0,0 +1,43 @@
+#ifndef CONNECTIVITY_H
+#define CONNECTIVITY_H
+
+#include <vector>
+#include <SFML/System.hpp>
+#include "SearchGrid.h"
+#include "SearchWorkspace.h"
+#include "../UI-UX/Map.h"
+
+// Labels every walkable tile with its connected component, so a query whose ends lie
+// in different components is rejected before any search floods the start's region.
+// A spread tick only closes tiles, which can split a component but never join two:
+// each closed tile races a BFS from each of its open neighbours, and whichever regions
+// run out before meeting the others are cut off and get new labels. The largest part
+// is never walked, so a split costs about the size of the smaller side.
+class Connectivity {
+    SearchGrid grid;
+    std::vector<int> label;     // component of each tile, -1 for lava
+    int nextLabel = 0;
+    int tilesRelabelled = 0;
+
+    // Scratch state for the racing searches
+    SearchWorkspace owner;      // cost field = which racing search reached the tile
+    std::vector<int> queues[4];
+    size_t heads[4] = {0, 0, 0, 0};
+    std::vector<unsigned char> closedTiles;
+
+    void build();
+    void close(int tile);
+    int flood(int seed, int newLabel);
+
+public:
+    // Full labelling after a regeneration, local splits after a spread tick
+    void sync(const Map& map);
+
+    // O(1); false if either tile is lava
+    bool connected(sf::Vector2i a, sf::Vector2i b) const;
+
+    // Tiles that changed label in the last sync
+    int getTilesRelabelled() const { return tilesRelabelled; }
+};
+
+#endif //CONNECTIVITY_H
@@ -0,0 +1,108 @@
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include <future>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <SFML/System.hpp>
+#include "SearchGrid.h"
+#include "SearchWorkspace.h"
+#include "../UI-UX/Map.h"
+
+// Customizable contraction hierarchy. The contraction order and the shortcut arcs are
+// built once per map size over every tile, lava or not (nested dissection of the grid),
+// so they never depend on where the lava is. Customization then gives the arcs their
+// weights for the current lava: all of them after a regeneration, and after a spread
+// tick only the arcs whose shortcuts ran through the newly closed tiles.
+// Queries are two upward searches that meet at the highest-ranked tile of the path.
+// Spread ticks are caught up at query time, so the game pays nothing per frame for them.
+class ContractionHierarchy {
+    static constexpr int INF = 1 << 29;
+
+    SearchGrid grid;
+    int builtWidth = 0;
+    int builtHeight = 0;
+
+    // Everything below is indexed by rank (contraction order), not by tile
+    std::vector<int> rankOf;     // tile -> rank
+    std::vector<int> tileOf;     // rank -> tile
+    std::vector<int> firstUp;    // arcs of rank r are [firstUp[r], firstUp[r + 1])
+    std::vector<int> upHead;     // higher endpoint of each arc, sorted within a node
+    std::vector<int> weight;     // INF if the arc is closed
+    std::vector<int> middle;     // lower tile of the triangle the weight came through, -1 for a grid edge
+    std::vector<int> firstDown;  // incoming arcs from lower ranks, for partial customization
+    std::vector<int> downArc;
+    std::vector<int> downTail;   // lower endpoint of each incoming arc, ascending within a node
+
+    // Scratch state reused between queries and customizations
+    SearchWorkspace forward;
+    SearchWorkspace backward;
+    std::vector<unsigned char> previousWalkable;
+    std::vector<int> closedTiles;
+    std::vector<std::pair<int, int>> dirtyArcs; // (lower rank, arc) min-heap
+    std::vector<unsigned char> arcDirty;
+
+    int nodesExplored = 0;
+    int arcsUpdated = 0;
+
+    void buildTopology(int width, int height);
+    void customize();
+    void customize(const std::vector<int>& closedTiles);
+    int findArc(int low, int high) const;
+    int parentOf(int rank) const { return firstUp[rank] < firstUp[rank + 1] ? upHead[firstUp[rank]] : -1; }
+    void relax(SearchWorkspace& side, int rank);
+    int edgeWeight(int low, int high) const;
+    void markDirty(int a, int b);
+    void unpack(int from, int to, std::vector<sf::Vector2i>& out) const;
+
+public:
+    // Takes snapshot as the grid, builds the topology if the size changed and customizes
+    // every arc. About half a second on the game map, so Contractions runs it off the frame.
+    void rebuild(const SearchGrid& snapshot);
+
+    // Builds the hierarchy on first use or when the map size changes, then re-customizes
+    // for regenerations (every arc) and spreads (only the arcs the closed tiles affected)
+    void sync(const Map& map);
+
+    // Syncs, then answers the query on the hierarchy
+    std::vector<sf::Vector2i> findPath(const Map& map, sf::Vector2i start, sf::Vector2i goal);
+
+    // Tiles whose arcs the last query's two searches scanned
+    int getNodesExplored() const { return nodesExplored; }
+    // Arcs re-weighted by the last customization
+    int getArcsUpdated() const { return arcsUpdated; }
+    int getArcCount() const { return static_cast<int>(upHead.size()); }
+};
+
+// Keeps a contraction hierarchy for the current lava layout. Nothing is built until it
+// is requested; then the topology and the full customization run on a background thread,
+// and again after every regeneration. Until that finishes there is no hierarchy.
+class Contractions {
+    SearchGrid grid;
+    std::unique_ptr<ContractionHierarchy> hierarchy;
+    std::future<std::unique_ptr<ContractionHierarchy>> building;
+    bool rebuildAgain = false; // the layout changed again while building
+    bool waiting = false;      // a request is waiting for the build
+    bool justFinished = false;
+
+    // Hands previous (or a new hierarchy) to a background thread to rebuild for grid
+    void startBuild(std::unique_ptr<ContractionHierarchy> previous);
+
+public:
+    // Called every frame: starts a rebuild after a regeneration and picks up finished ones
+    void sync(const Map& map);
+
+    // Starts the first build if there is nothing yet. Returns true if the hierarchy is ready now.
+    bool request();
+
+    bool isBuilding() const { return building.valid(); }
+
+    // True once, on the first sync after a build a request was waiting for
+    bool takeFinished();
+
+    // The hierarchy for the current layout, or null while it is being built
+    ContractionHierarchy* get() const { return hierarchy.get(); }
+};
+
+#endif //CONTRACTIONHIERARCHY_H
@@ -0,0 +1,108 @@
+#ifndef COOPERATIVEPLANNER_H
+#define COOPERATIVEPLANNER_H
+
+#include <vector>
+#include <SFML/System.hpp>
+#include "Landmarks.h"
+#include "ReservationTable.h"
+#include "SearchGrid.h"
+#include "SearchKernel.h"
+#include "ThreadPool.h"
+
+struct Agent {
+    sf::Vector2i position;
+    sf::Vector2i goal;
+    std::vector<sf::Vector2i> plan; // tile at each step of the current round; plan[0] is position
+};
+
+struct PlanningStats {
+    int agents = 0;
+    int waiting = 0;     // found no window that avoids every other agent, so stand still
+    int bumped = 0;      // plans dropped because they ran through a waiting agent's tile, then replanned
+    int waves = 0;       // parallel planning passes
+    int rejected = 0;    // plans made in parallel that clashed with one committed before them
+    int serial = 0;      // agents planned one by one in the last pass
+    long long expanded = 0;
+    double wallMs = 0;
+};
+
+// Windowed hierarchical cooperative A* (WHCA*). Each round every agent plans its next
+// `window` steps through space and time, avoiding the (tile, step) cells that agents ahead
+// of it in the list have reserved, including head-on swaps. Beyond the window an agent
+// follows the heuristic, which uses the landmark distances as the abstract map.
+//
+// Planning is spread over a thread pool in waves: every waiting agent plans against the
+// reservations made so far, then the plans are committed one by one in priority order.
+// A plan that clashes with one committed earlier in the same wave goes to the next wave;
+// the last few are planned one at a time. Which agents go in which wave, and so the plans,
+// don't depend on the thread count.
+class CooperativePlanner {
+    // Visited (tile, step) states of one search, in an open-addressing hash table. Key is
+    // step * tileCount + tile; entries from older searches are told apart by a stamp.
+    class StateTable {
+        std::vector<int> keys;
+        std::vector<int> costs;
+        std::vector<int> parents;
+        std::vector<unsigned> stamps;
+        unsigned generation = 0;
+        size_t used = 0;
+
+        size_t slotOf(int key) const;
+        void grow();
+
+    public:
+        void reset();
+        // Slot of key, or -1 if it wasn't reached
+        int find(int key) const;
+        int insert(int key, int cost, int parent);
+        int keyAt(int slot) const { return keys[slot]; }
+        int costAt(int slot) const { return costs[slot]; }
+        int parentAt(int slot) const { return parents[slot]; }
+        void update(int slot, int cost, int parent) {
+            costs[slot] = cost;
+            parents[slot] = parent;
+        }
+    };
+
+    struct Worker {
+        StateTable states;
+        BinaryHeapOpen open;
+        int expanded = 0;
+    };
+
+    ThreadPool pool;
+    std::vector<Worker> workers;    // one per pool thread
+    int window;
+    int maxExpansions;              // per agent and round; past this it waits
+    ReservationTable reservations;
+    int roundStart = 0;             // step the agents' plan[0] is at
+    int planned = 0;                // agents whose plans are in the table
+
+    bool searchWindow(Worker& worker, const SearchGrid& grid, const LandmarkTable* landmarks,
+                      int agent, const Agent& a, std::vector<sf::Vector2i>& plan) const;
+    bool clashes(int agent, const std::vector<sf::Vector2i>& plan, const SearchGrid& grid) const;
+    void commit(int agent, const std::vector<sf::Vector2i>& plan, const SearchGrid& grid);
+
+public:
+    // threadCount 0 means one thread per core
+    explicit CooperativePlanner(int windowSteps = 16, unsigned threadCount = 0, int maxExpansionsPerAgent = 4096);
+
+    unsigned getThreadCount() const { return pool.size(); }
+    int getWindow() const { return window; }
+
+    // Forget every reservation, e.g. after the agents were replaced
+    void reset();
+
+    // Plan the next window for every agent, in priority order (earlier in the list first).
+    // Landmarks may be null, then the heuristic is plain Manhattan.
+    PlanningStats planRound(const SearchGrid& grid, const LandmarkTable* landmarks, std::vector<Agent>& agents);
+
+    // Pairs of agents whose current plans put them on the same tile at the same step; always
+    // 0 after planRound, for checking
+    int countConflicts(const std::vector<Agent>& agents) const;
+
+    // Move every agent `steps` along its plan; replan before going past window / 2
+    void advance(std::vector<Agent>& agents, int steps);
+};
+
+#endif //COOPERATIVEPLANNER_H
@@ -0,0 +1,65 @@
+#ifndef DSTARLITE_H
+#define DSTARLITE_H
+
+#include <vector>
+#include <SFML/System.hpp>
+#include "SearchGrid.h"
+#include "../UI-UX/Map.h"
+
+// D* Lite: searches backwards from a fixed destination and keeps its search tree
+// between queries. When lava changes tiles or the NaviGator walks, only the part
+// of the tree that the change affects is repaired.
+class DStarLite {
+    struct OpenEntry {
+        int k1, k2, tile;
+        bool operator>(const OpenEntry& other) const {
+            return k1 != other.k1 ? k1 > other.k1 : (k2 != other.k2 ? k2 > other.k2 : tile > other.tile);
+        }
+    };
+
+    SearchGrid grid;
+    std::vector<int> g;
+    std::vector<int> rhs;
+    std::vector<int> key1, key2;          // current key of each queued tile
+    std::vector<unsigned char> queued;
+    std::vector<OpenEntry> open;          // min-heap with lazy deletion
+
+    sf::Vector2i start;
+    sf::Vector2i lastStart;               // start at the time km was last updated
+    sf::Vector2i goal;
+    int km = 0;
+    bool active = false;
+    bool dirty = false;                   // start moved or tiles changed since the last replan
+
+    int nodesExpanded = 0;
+
+    int heuristic(int tile) const;
+    void calculateKey(int tile, int& k1, int& k2) const;
+    void push(int tile);
+    void updateVertex(int tile);
+    void tileChanged(int tile);
+    void catchUpStart();
+    void computeShortestPath();
+
+public:
+    // Plan towards a new destination from scratch
+    void setGoal(const Map& map, sf::Vector2i from, sf::Vector2i destination);
+    void clear() { active = false; }
+    bool isActive() const { return active; }
+    sf::Vector2i getGoal() const { return goal; }
+
+    // Feed the map's changes (one spread tick is applied tile by tile) and the NaviGator's tile
+    void sync(const Map& map);
+    void moveStart(sf::Vector2i tile);
+
+    // Repair the search tree if anything changed. Returns true if it did any work.
+    bool replan();
+
+    // Walk down the cost-to-goal values from the current start; empty if the goal is cut off
+    std::vector<sf::Vector2i> getPath() const;
+
+    // Tiles expanded by the last replan
+    int getNodesExpanded() const { return nodesExpanded; }
+};
+
+#endif //DSTARLITE_H
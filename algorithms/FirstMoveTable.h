@@ -0,0 +1,91 @@
+#ifndef FIRSTMOVETABLE_H
+#define FIRSTMOVETABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include <SFML/System.hpp>
+#include "SearchGrid.h"
+#include "SearchResult.h"
+#include "../UI-UX/Map.h"
+
+// Compressed path database: for every walkable source tile, the first step of a shortest
+// path to every other tile, so a query is one lookup per step and no search at all.
+//
+// Each source's row lists the destinations in depth-first order of the walkable tiles,
+// which keeps neighbouring destinations next to each other, and stores it run-length
+// encoded. Where several first steps are shortest the encoder picks the one that lets the
+// current run go on, and destinations that can't be reached may join any run.
+struct FirstMoveTable {
+    unsigned layout = ~0u;               // Map layout the table belongs to (not saved)
+    uint64_t walkableHash = 0;           // hashWalkable of the grid it was built from
+    int width = 0;
+    int height = 0;
+    std::vector<int> order;              // walkable tiles in depth-first order
+    std::vector<int> rank;               // tile -> position in order, -1 if it was lava
+    std::vector<int> component;          // rank -> connected region, so unreachable goals fail at once
+    std::vector<uint32_t> rowStart;      // tile -> first run of its row (rows in tile order, so a step
+                                         // sideways usually finds its row in the same cache line), plus an end marker
+    std::vector<uint32_t> runs;          // first destination rank << 2 | direction
+    double buildMs = 0;
+    mutable std::atomic<uint64_t> fittedGrid{~0ull}; // layout << 32 | version of the last grid fits() passed
+
+    // FNV-1a over the size and walkable tiles, to tell whether a saved table was built for this lava
+    static uint64_t hashWalkable(const SearchGrid& grid);
+
+    // One BFS per walkable tile, spread over threadCount threads (0 means one per core)
+    static std::shared_ptr<FirstMoveTable> build(const SearchGrid& grid, unsigned threadCount = 0);
+
+    // Binary file; load returns null if the file is missing or not a table
+    bool save(const std::string& path) const;
+    static std::shared_ptr<FirstMoveTable> load(const std::string& path);
+
+    // Same size, and every tile walkable on grid was walkable when the table was built
+    bool fits(const SearchGrid& grid) const;
+    size_t bytes() const;
+
+    // Direction (0 +x, 1 -x, 2 +y, 3 -y) of the first step from source to target, or -1
+    // if either was lava when the table was built or there is no way between them
+    int firstMove(int source, int target) const;
+
+    // Follows the table from start to goal. Fails with SearchFailure::Outdated if the table
+    // doesn't fit grid, or if lava has spread onto the path since the table was built.
+    SearchResult findPath(const SearchGrid& grid, sf::Vector2i start, sf::Vector2i goal) const;
+};
+
+// Keeps a first-move table for the current lava layout. Tables are only made on request:
+// loaded from disk if the file holds one built for this layout, otherwise built on a
+// background thread and saved over it. A regeneration drops the table.
+//
+// The table is always built from the grid as the layout was generated, before any lava
+// spread, so the same layout gives the same table and file whenever it comes up again.
+class FirstMoves {
+    SearchGrid grid;
+    SearchGrid layoutGrid;      // grid on the first sync of this layout
+    uint64_t layoutHash = 0;
+    std::shared_ptr<const FirstMoveTable> table;
+    std::future<std::shared_ptr<FirstMoveTable>> building;
+    bool justFinished = false;
+
+public:
+    // Called every frame: drops the table after a regeneration and picks up finished builds
+    void sync(const Map& map);
+
+    // Loads the table from file if it was built for this layout, or starts building it (and
+    // saving it over file) if not.
+    // Returns true if the table is ready now.
+    bool request(const std::string& file);
+
+    bool isBuilding() const { return building.valid(); }
+
+    // True once, on the first sync after a background build finished
+    bool takeFinished();
+
+    // The table for the current layout, or null if there is none yet
+    std::shared_ptr<const FirstMoveTable> get() const { return table; }
+};
+
+#endif //FIRSTMOVETABLE_H
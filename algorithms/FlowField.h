@@ -0,0 +1,50 @@
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include <climits>
+#include <utility>
+#include <vector>
+#include <SFML/System.hpp>
+#include "SearchGrid.h"
+#include "../UI-UX/Map.h"
+
+// Distance to one destination from every tile, found by a single BFS backwards from it,
+// plus the step each tile takes towards it. Any start's path is then a walk down the
+// field with no search. Lava only ever closes tiles, so a spread tick is repaired by
+// re-deriving just the tiles whose way to the goal ran through the new lava.
+class FlowField {
+    SearchGrid grid;
+    std::vector<int> distance;             // steps to the goal, INT_MAX if cut off
+    std::vector<signed char> nextStep;     // direction index of the next tile, -1 if none
+    std::vector<std::pair<int, int>> heap; // (distance, tile) min-heap used by the repair
+    std::vector<int> invalidated;
+
+    sf::Vector2i goal;
+    bool active = false;
+    int tilesUpdated = 0;
+
+    void build();
+    void repair(const std::vector<int>& closedTiles);
+
+public:
+    // Run the backward BFS over the whole map; false if the goal isn't walkable
+    bool setGoal(const Map& map, sf::Vector2i destination);
+    void clear() { active = false; }
+    bool isActive() const { return active; }
+    sf::Vector2i getGoal() const { return goal; }
+
+    // Apply the map's lava changes. Returns true if any tile's distance changed.
+    // Lava on the goal itself deactivates the field.
+    bool sync(const Map& map);
+
+    // Steps from tile to the goal, INT_MAX if there is no way there
+    int distanceFrom(sf::Vector2i tile) const;
+
+    // Walk the field from a tile to the goal; empty if the goal can't be reached
+    std::vector<sf::Vector2i> pathFrom(sf::Vector2i tile) const;
+
+    // Tiles written by the last build or repair
+    int getTilesUpdated() const { return tilesUpdated; }
+};
+
+#endif //FLOWFIELD_H
@@ -0,0 +1,64 @@
+#ifndef HASHDISTRIBUTEDASTAR_H
+#define HASHDISTRIBUTEDASTAR_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <SFML/System.hpp>
+#include "SearchGrid.h"
+#include "SearchKernel.h"
+#include "SearchResult.h"
+#include "SearchWorkspace.h"
+#include "MpscInbox.h"
+#include "ThreadPool.h"
+
+// Hash-distributed A* (HDA*), meant for maps too big for one thread. Every tile belongs to
+// one thread, picked by hashing the square block it lies in, and only that thread opens,
+// closes or updates it. A thread that reaches tiles it doesn't own posts them in batches
+// to the owner's lock-free inbox. Hashing blocks rather than single tiles keeps most moves
+// inside one thread while still spreading the frontier evenly.
+//
+// The first goal path found is only an upper bound. Threads carry on until no open tile
+// could beat it, and the search ends once no message is in flight and every thread has
+// run out of such tiles (see findPath).
+class HashDistributedAStar {
+    struct Message {
+        int tile = 0;
+        int cost = 0;
+        int parent = 0;
+    };
+
+    struct Partition {
+        BinaryHeapOpen open;
+        MpscInbox<std::vector<Message>> inbox;    // batches the other threads sent here
+        std::vector<std::vector<Message>> outbox; // per owner, filled during one batch of expansions
+        long long credits = 0;                    // messages taken in but not yet accounted for
+        long long sent = 0;
+        SearchStats stats;
+    };
+
+    ThreadPool pool;
+    int blockShift;                            // blocks are 2^blockShift tiles on a side
+    std::vector<std::unique_ptr<Partition>> partitions;
+    SearchWorkspace workspace;                 // each tile is only ever written by its owner
+    std::atomic<int> incumbent{0};             // cost of the best goal path so far
+    std::atomic<long long> outstanding{0};     // messages sent but not yet accounted for by their receiver
+    long long messages = 0;
+
+    unsigned ownerOf(int x, int y) const;
+    void run(unsigned self, const SearchGrid& grid, sf::Vector2i goal);
+
+public:
+    // threadCount 0 means one thread per core; blockSize is rounded down to a power of two
+    explicit HashDistributedAStar(unsigned threadCount = 0, int blockSize = 8);
+
+    unsigned getThreadCount() const { return pool.size(); }
+
+    // Shortest 4-connected path, the same length single-threaded A* finds
+    SearchResult findPath(const SearchGrid& grid, sf::Vector2i start, sf::Vector2i goal);
+
+    // Tiles the last search sent from one thread to another
+    long long getMessages() const { return messages; }
+};
+
+#endif //HASHDISTRIBUTEDASTAR_H
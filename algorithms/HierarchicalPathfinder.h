@@ -0,0 +1,83 @@
+#ifndef HIERARCHICALPATHFINDER_H
+#define HIERARCHICALPATHFINDER_H
+
+#include <vector>
+#include <utility>
+#include <SFML/System.hpp>
+#include "SearchGrid.h"
+#include "SearchWorkspace.h"
+#include "../UI-UX/Map.h"
+
+// A route found on the abstract graph, turned into tiles a few segments at a time
+struct HpaRoute {
+    std::vector<sf::Vector2i> waypoints; // start, cluster entrances..., goal
+    std::vector<sf::Vector2i> tiles;     // refined prefix, tile by tile
+    size_t refinedSegments = 0;
+    int length = 0;                      // abstract length of the whole route in steps
+
+    bool empty() const { return waypoints.empty(); }
+    bool isComplete() const { return !waypoints.empty() && refinedSegments + 1 >= waypoints.size(); }
+
+    // Refined tiles followed by the waypoints still to refine, for the GPS to draw
+    std::vector<sf::Vector2i> preview() const;
+};
+
+// HPA*: the map is cut into clusters (the TMX chunks) and an abstract graph links the
+// entrances on cluster borders, with the distances inside each cluster cached.
+// Queries search the abstract graph; lava only rebuilds the clusters it lands in.
+class HierarchicalPathfinder {
+    struct Node {
+        int tile;
+        int cluster;
+        int slot;    // position in its cluster's node list
+        int partner; // matching node on the other side of the border
+    };
+
+    struct Cluster {
+        int left, top, right, bottom; // inclusive tile bounds
+        std::vector<int> nodes;
+        std::vector<int> distances;   // nodes.size() squared, -1 = unreachable inside the cluster
+    };
+
+    SearchGrid grid;
+    int clusterWidth = 64;
+    int clusterHeight = 64;
+    int clustersX = 0;
+    int clustersY = 0;
+
+    std::vector<Node> nodes;
+    std::vector<int> freeNodes;
+    std::vector<Cluster> clusters;
+    std::vector<std::vector<int>> borderNodes; // nodes each border created, vertical borders first
+
+    // Scratch state reused between queries
+    SearchWorkspace workspace;
+    SearchWorkspace bfsWorkspace;
+    std::vector<std::pair<int, int>> open;
+    std::vector<int> bfsQueue;
+
+    int nodesExplored = 0;
+
+    void build();
+    void buildBorder(int border);
+    void buildClusterDistances(int cluster);
+    void clusterBfs(int cluster, int fromTile);
+    int clusterOf(int x, int y) const { return (y / clusterHeight) * clustersX + x / clusterWidth; }
+    int verticalBorderCount() const { return (clustersX - 1) * clustersY; }
+    bool refineSegment(sf::Vector2i from, sf::Vector2i to, std::vector<sf::Vector2i>& out);
+
+public:
+    // Regeneration rebuilds the whole graph; a spread tick rebuilds only the clusters it touched
+    void sync(const Map& map);
+
+    // Search the abstract graph; the route starts unrefined
+    bool findRoute(const Map& map, sf::Vector2i start, sf::Vector2i goal, HpaRoute& route);
+
+    // Turn the next few abstract segments into tiles. False if lava has since cut a segment.
+    bool refine(HpaRoute& route, int segments);
+
+    int getNodesExplored() const { return nodesExplored; }
+    int getNodeCount() const { return static_cast<int>(nodes.size() - freeNodes.size()); }
+};
+
+#endif //HIERARCHICALPATHFINDER_H
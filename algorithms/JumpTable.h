@@ -0,0 +1,38 @@
+#ifndef JUMPTABLE_H
+#define JUMPTABLE_H
+
+#include <vector>
+#include <cstdint>
+#include "SearchGrid.h"
+
+// Precomputed jump distances for JPS+.
+// For every tile and each of the four directions it stores how far a jump goes:
+//   > 0  distance to the next jump point
+//   <= 0 minus the number of open tiles before a wall (0 = wall right next to the tile)
+// A horizontal run stops at a forced neighbour; a vertical run stops at any tile
+// whose horizontal runs reach a jump point, mirroring Pathfinder::findJPSPath.
+class JumpTable {
+public:
+    enum Direction { EAST, WEST, SOUTH, NORTH };
+
+private:
+    int width = 0;
+    int height = 0;
+    std::vector<int16_t> distances[4];
+    std::vector<unsigned char> verticalStop; // tile has a horizontal jump point to either side
+
+    void computeRow(const SearchGrid& grid, int y);
+    void computeColumn(const SearchGrid& grid, int x);
+    bool updateVerticalStop(int tile);
+
+public:
+    void build(const SearchGrid& grid);
+
+    // Recompute only the rows and columns the changed tiles can influence
+    void update(const SearchGrid& grid, const std::vector<int>& changedTiles);
+
+    bool isBuilt() const { return width > 0; }
+    int distance(int tile, Direction dir) const { return distances[dir][tile]; }
+};
+
+#endif //JUMPTABLE_H
@@ -0,0 +1,70 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <vector>
+#include <SFML/System.hpp>
+#include "SearchGrid.h"
+#include "../UI-UX/Map.h"
+
+// Exact distances from a few landmark tiles to every tile, for the ALT heuristic:
+// by the triangle inequality |d(L, goal) - d(L, tile)| never overestimates d(tile, goal).
+// Spreading lava only makes real distances longer, so a table stays admissible (and
+// consistent) for every grid with the same layout; only a regeneration invalidates it.
+struct LandmarkTable {
+    static constexpr int MAX_LANDMARKS = 16;
+    static constexpr uint16_t UNREACHABLE = 0xFFFF;
+
+    int count = 0;
+    unsigned layout = ~0u;                 // Map layout the distances were measured on
+    std::vector<sf::Vector2i> landmarks;
+    std::vector<uint16_t> distances;       // distances[tile * count + k], all K for a tile in one cache line
+
+    // Picks count landmarks by farthest-point selection and runs one BFS from each
+    static std::shared_ptr<const LandmarkTable> build(const SearchGrid& grid, int count);
+
+    bool matches(const SearchGrid& grid) const {
+        return count > 0 && grid.layout == layout && distances.size() == static_cast<size_t>(grid.tileCount()) * count;
+    }
+
+    const uint16_t* at(int tile) const { return &distances[static_cast<size_t>(tile) * count]; }
+
+    // Lower bound on the distance from tile to the goal whose row is goalRow
+    int estimate(int tile, const uint16_t* goalRow) const {
+        const uint16_t* row = at(tile);
+        int best = 0;
+        for (int k = 0; k < count; ++k) {
+            if (row[k] == UNREACHABLE || goalRow[k] == UNREACHABLE) continue;
+            int difference = row[k] > goalRow[k] ? row[k] - goalRow[k] : goalRow[k] - row[k];
+            if (difference > best) best = difference;
+        }
+        return best;
+    }
+};
+
+// Keeps a landmark table for the current lava layout, rebuilding it on a background
+// thread after every regeneration. Until the new table is ready there is none.
+class Landmarks {
+    SearchGrid grid;
+    int count;
+    std::shared_ptr<const LandmarkTable> table;
+    std::future<std::shared_ptr<const LandmarkTable>> building;
+    bool rebuildAgain = false; // the layout changed again while building
+
+    void startBuild();
+
+public:
+    explicit Landmarks(int landmarkCount = 8) : count(landmarkCount) {}
+
+    // Called every frame: starts a rebuild after a regeneration and picks up finished ones
+    void sync(const Map& map);
+
+    bool isBuilding() const { return building.valid(); }
+
+    // The table for the current layout, or null while it is being built
+    std::shared_ptr<const LandmarkTable> get() const { return table; }
+};
+
+#endif //LANDMARKS_H
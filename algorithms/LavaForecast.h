@@ -0,0 +1,52 @@
+#ifndef LAVAFORECAST_H
+#define LAVAFORECAST_H
+
+#include <climits>
+#include <vector>
+#include <SFML/System.hpp>
+#include "SearchGrid.h"
+#include "../UI-UX/Map.h"
+
+// When lava could reach each tile. Every spread tick a lava tile grows into at most one
+// neighbour, so lava needs at least as many ticks as the tile's distance from the
+// nearest spreading lava. One multi-source BFS gives those distances for the whole map;
+// after that each tick only lowers the distances around the tiles it turned to lava.
+// The result is a lower bound: a tile it calls safe for T seconds really is.
+class LavaForecast {
+    SearchGrid grid;
+    std::vector<int> ticks;      // spread ticks before lava can arrive; 0 on lava, NEVER if it can't
+    std::vector<int> queue;
+    unsigned tick = 0;           // map's spread tick the counts start from
+    float secondsToNextTick = Map::lavaSpreadInterval;
+    int tilesUpdated = 0;
+
+    void build(const Map& map);
+    void spreadFrom(size_t head);
+
+public:
+    static constexpr int NEVER = INT_MAX;
+
+    // Bring the forecast up to this frame: a spread tick relaxes outward from its new lava,
+    // a regeneration or a missed tick starts over
+    void sync(const Map& map);
+
+    // Spread ticks from now until lava could be on the tile, 0 if it already is
+    int ticksUntilLava(int x, int y) const {
+        return grid.inBounds(x, y) ? ticks[grid.index(x, y)] : 0;
+    }
+    int ticksUntilLava(sf::Vector2i tile) const { return ticksUntilLava(tile.x, tile.y); }
+
+    // Seconds until lava could be on the tile: 0 if it already is, a huge number if it never can
+    float secondsUntilLava(int x, int y) const;
+    bool isSafeFor(int x, int y, float seconds) const { return secondsUntilLava(x, y) > seconds; }
+    bool isSafeFor(sf::Vector2i tile, float seconds) const { return isSafeFor(tile.x, tile.y, seconds); }
+
+    unsigned getTick() const { return tick; }
+    float getSecondsToNextTick() const { return secondsToNextTick; }
+    const SearchGrid& getGrid() const { return grid; }
+
+    // Tiles whose count changed in the last sync
+    int getTilesUpdated() const { return tilesUpdated; }
+};
+
+#endif //LAVAFORECAST_H
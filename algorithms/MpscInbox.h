@@ -0,0 +1,52 @@
+#ifndef MPSCINBOX_H
+#define MPSCINBOX_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+// Lock-free inbox any number of threads can post to and exactly one thread drains.
+// Posting pushes onto an intrusive stack; the owner takes the whole stack in one exchange,
+// so nodes are never popped one at a time and the ABA problem can't arise. Memory grows
+// with what is actually posted, not with the number of senders.
+template <typename T>
+class MpscInbox {
+    struct Node {
+        T value;
+        Node* next;
+    };
+
+    std::atomic<Node*> top{nullptr};
+
+public:
+    MpscInbox() = default;
+    ~MpscInbox() {
+        drain([](T&) {});
+    }
+
+    MpscInbox(const MpscInbox&) = delete;
+    MpscInbox& operator=(const MpscInbox&) = delete;
+
+    // Any thread
+    void post(T&& value) {
+        Node* node = new Node{std::move(value), top.load(std::memory_order_relaxed)};
+        while (!top.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+
+    // Owner only: calls fn on everything posted so far, newest first. Returns how many.
+    template <typename Fn>
+    size_t drain(Fn&& fn) {
+        Node* node = top.exchange(nullptr, std::memory_order_acquire);
+        size_t count = 0;
+        while (node) {
+            Node* next = node->next;
+            fn(node->value);
+            delete node;
+            node = next;
+            count++;
+        }
+        return count;
+    }
+};
+
+#endif //MPSCINBOX_H
@@ -0,0 +1,93 @@
+#ifndef PATHCACHE_H
+#define PATHCACHE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <SFML/System.hpp>
+#include "PathService.h"
+#include "SearchGrid.h"
+#include "../UI-UX/Map.h"
+
+struct CachedPath {
+    std::vector<sf::Vector2i> path; // empty = no path exists
+    int nodesExplored = 0;          // what the original search cost
+};
+
+// Remembers finished searches by (start, goal, algorithm). Spreading lava only closes
+// tiles, which can't make a path shorter, so a cached path stays optimal until lava
+// lands on one of its own tiles; a per-tile index finds exactly those entries. Cached
+// "no path" answers stay true for the same reason. A regeneration clears everything.
+class PathCache {
+    struct Key {
+        int start;
+        int goal;
+        PathQuery query;
+        bool operator==(const Key& other) const {
+            return start == other.start && goal == other.goal && query == other.query;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return (static_cast<size_t>(key.start) * 1000003u ^ static_cast<size_t>(key.goal)) * 31u
+                   + static_cast<size_t>(key.query);
+        }
+    };
+    struct Entry {
+        CachedPath value;
+        unsigned id;       // tells this entry apart from an older one under the same key
+        unsigned lastUsed;
+    };
+
+    SearchGrid grid;
+    std::unordered_map<Key, Entry, KeyHash> entries;
+    std::vector<std::vector<std::pair<Key, unsigned>>> entriesOnTile; // (key, id) of each path crossing a tile
+    size_t indexed = 0;     // references in entriesOnTile, live or left behind by evicted entries
+    size_t indexLimit = 0;  // rebuild the index once indexed passes this
+    std::vector<unsigned char> previousWalkable;
+    size_t capacity;
+    unsigned nextId = 0;
+    unsigned useClock = 0;
+
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t invalidations = 0;
+
+    Key keyOf(sf::Vector2i start, sf::Vector2i goal, PathQuery query) const {
+        return {grid.index(start), grid.index(goal), query};
+    }
+    void invalidateTile(int tile);
+    void rebuildIndex();
+    CachedPath* lookup(sf::Vector2i start, sf::Vector2i goal, PathQuery query);
+
+public:
+    explicit PathCache(size_t maxEntries = 256) : capacity(maxEntries) {}
+
+    // Drop the entries whose paths lava has landed on since the last sync. Every frame.
+    void sync(const Map& map);
+
+    // Counts a hit or a miss; null on a miss
+    const CachedPath* find(sf::Vector2i start, sf::Vector2i goal, PathQuery query);
+
+    // One lookup for two queries answered together (Compare mode): a hit only if both are
+    // cached with a path. Both are null on a miss.
+    void findPair(sf::Vector2i start, sf::Vector2i goal, PathQuery first, PathQuery second,
+                  const CachedPath*& firstPath, const CachedPath*& secondPath);
+
+    // Store a result searched on a grid of the given layout. Results computed on an older
+    // snapshot are still kept if none of their tiles have closed since.
+    void store(sf::Vector2i start, sf::Vector2i goal, PathQuery query, unsigned layout,
+               const std::vector<sf::Vector2i>& path, int nodesExplored);
+
+    void clear();
+
+    size_t getHits() const { return hits; }
+    size_t getMisses() const { return misses; }
+    size_t getInvalidations() const { return invalidations; }
+    float hitRate() const { return hits + misses ? static_cast<float>(hits) / (hits + misses) : 0.f; }
+
+    // e.g. "cache: 12 hits / 4 misses (75%), 3 invalidated"
+    std::string report() const;
+};
+
+#endif //PATHCACHE_H
@@ -0,0 +1,84 @@
+#ifndef PATHSERVICE_H
+#define PATHSERVICE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <SFML/System.hpp>
+#include "SearchGrid.h"
+#include "Landmarks.h"
+#include "SpscQueue.h"
+#include "SearchResult.h"
+
+enum class PathQuery { Dijkstra, AStar, BidirectionalDijkstra, BidirectionalAStar, JPS, ALT };
+
+enum class PathStatus { Found, NoPath, Cancelled, TimedOut };
+
+struct PathResult {
+    unsigned handle = 0;
+    PathQuery query = PathQuery::AStar;
+    sf::Vector2i start;
+    sf::Vector2i goal;
+    unsigned layout = 0; // Map layout of the grid that was searched
+    PathStatus status = PathStatus::NoPath;
+    std::vector<sf::Vector2i> path;
+    SearchStats stats; // counters, wall time and failure reason of the search
+};
+
+// Runs path queries on a worker thread so the game loop never blocks on a search.
+// submit() returns a handle right away; finished results come back through poll(),
+// which the main loop drains every frame. Queries can be cancelled or given a deadline.
+class PathService {
+    struct Request {
+        unsigned handle;
+        PathQuery query;
+        sf::Vector2i start;
+        sf::Vector2i goal;
+        std::shared_ptr<const SearchGrid> grid;
+        std::shared_ptr<const LandmarkTable> landmarks; // ALT only
+        std::chrono::steady_clock::time_point deadline;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+    };
+
+    std::shared_ptr<const SearchGrid> snapshot; // reused while the map version doesn't change
+    unsigned nextHandle = 1;
+
+    std::mutex requestMutex; // guards requests, pending and stopping
+    std::condition_variable wake;
+    std::deque<Request> requests;
+    std::unordered_map<unsigned, std::shared_ptr<std::atomic<bool>>> pending;
+    bool stopping = false;
+
+    SpscQueue<PathResult, 64> results; // worker -> main thread
+    std::thread worker;
+
+    void run();
+
+public:
+    PathService();
+    ~PathService();
+
+    PathService(const PathService&) = delete;
+    PathService& operator=(const PathService&) = delete;
+
+    // Queue a search on a snapshot of grid. The handle is never 0.
+    // ALT queries need landmarks; without them they run as plain A*.
+    unsigned submit(PathQuery query, const SearchGrid& grid, sf::Vector2i start, sf::Vector2i goal,
+                    std::chrono::milliseconds timeout = std::chrono::milliseconds(2000),
+                    std::shared_ptr<const LandmarkTable> landmarks = nullptr);
+
+    // A cancelled query stops within a few hundred expansions and reports Cancelled
+    void cancel(unsigned handle);
+    void cancelAll();
+
+    // Main thread: takes the next finished result, if any
+    bool poll(PathResult& result) { return results.pop(result); }
+};
+
+#endif //PATHSERVICE_H
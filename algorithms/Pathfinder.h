@@ -0,0 +1,106 @@
+#ifndef PATHFINDER_H
+#define PATHFINDER_H
+
+#include <vector>
+#include <utility>
+#include <chrono>
+#include <functional>
+#include <SFML/System.hpp>
+#include "SearchGrid.h"
+#include "SearchWorkspace.h"
+#include "JumpTable.h"
+#include "Landmarks.h"
+#include "SearchKernel.h"
+#include "SearchResult.h"
+#include "../UI-UX/Map.h"
+
+// Long-lived pathfinder: keeps a flat copy of the map and a reusable workspace,
+// so repeated queries don't hash tiles or allocate search state.
+class Pathfinder {
+    SearchGrid grid;
+    SearchWorkspace workspace;
+    SearchWorkspace backwardWorkspace;     // second search of the bidirectional modes
+    JumpTable jumpTable;
+    bool jumpTableStale = true;
+    std::vector<std::pair<int, int>> open; // (priority, tile) min-heap for JPS and bidirectional search
+    std::vector<std::pair<int, int>> backwardOpen;
+    BinaryHeapOpen heapOpen;               // open lists of the search kernel, storage reused between queries
+    BucketOpen bucketOpen;
+    FifoOpen fifoOpen;
+    bool unitCostEngine = true;
+
+    SearchStats stats; // of the last query
+    std::chrono::steady_clock::time_point queryBegin;
+    std::function<bool()> stopCheck;
+    bool stopped = false;
+
+    // Asks the stop check every 256 expansions whether the running search should give up
+    bool shouldStop() {
+        if (!stopCheck || (stats.expanded & 255) != 0) return false;
+        return stopped = stopCheck();
+    }
+
+    // Start the stats and clock for a query; false, with the reason recorded, if an end is lava
+    bool beginQuery(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal);
+    // Record how the query ended and pass its path through
+    std::vector<sf::Vector2i> endQuery(std::vector<sf::Vector2i> path);
+
+    std::vector<sf::Vector2i> search(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal, bool useHeuristic,
+                                     const LandmarkTable* landmarks = nullptr);
+    std::vector<sf::Vector2i> searchBidirectional(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal, bool useHeuristic);
+    std::vector<sf::Vector2i> searchJPS(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal, bool precomputed);
+    std::vector<sf::Vector2i> buildPath(const SearchGrid& searchGrid, int startIndex, int goalIndex) const;
+
+public:
+    // Bring the internal grid (and any tables built from it) up to date with the map.
+    // Called every frame so each lava tick is applied as a small patch.
+    void sync(const Map& map);
+
+    std::vector<sf::Vector2i> findDijkstraPath(const Map& map, sf::Vector2i start, sf::Vector2i goal);
+    std::vector<sf::Vector2i> findAStarPath(const Map& map, sf::Vector2i start, sf::Vector2i goal);
+
+    // Search a grid the caller already owns (e.g. a snapshot)
+    std::vector<sf::Vector2i> findDijkstraPath(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal);
+    std::vector<sf::Vector2i> findAStarPath(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal);
+
+    // A* with the ALT heuristic: the larger of Manhattan and the landmark bound. Far better
+    // informed around lava lakes. Plain Manhattan A* if the table is for another layout.
+    std::vector<sf::Vector2i> findAStarPath(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal,
+                                            const LandmarkTable& landmarks);
+
+    // Search from both ends at once and stop once the frontiers have met and no shorter
+    // connection is possible; expands far less than one wavefront on long routes
+    std::vector<sf::Vector2i> findBidirectionalDijkstraPath(const Map& map, sf::Vector2i start, sf::Vector2i goal);
+    std::vector<sf::Vector2i> findBidirectionalAStarPath(const Map& map, sf::Vector2i start, sf::Vector2i goal);
+    std::vector<sf::Vector2i> findBidirectionalDijkstraPath(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal);
+    std::vector<sf::Vector2i> findBidirectionalAStarPath(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal);
+
+    // Jump Point Search: A* that skips over symmetric runs of open tiles, same path length as A*
+    std::vector<sf::Vector2i> findJPSPath(const Map& map, sf::Vector2i start, sf::Vector2i goal);
+    std::vector<sf::Vector2i> findJPSPath(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal);
+
+    // JPS+: same search, but every jump is a lookup in a precomputed table kept in sync with the map
+    std::vector<sf::Vector2i> findJPSPlusPath(const Map& map, sf::Vector2i start, sf::Vector2i goal);
+
+    // Every step on the grid costs 1, so Dijkstra can run as a BFS and A* on two buckets (f and f + 2)
+    // instead of a binary heap. On by default; turn off to compare against the heap.
+    void setUnitCostEngine(bool enabled) { unitCostEngine = enabled; }
+
+    // Polled while searching; once it returns true the search gives up and returns no path.
+    // Used for cancellation and deadlines by searches running off the main thread.
+    void setStopCheck(std::function<bool()> check) { stopCheck = std::move(check); }
+
+    // True if the last query was abandoned by the stop check rather than finding no path
+    bool wasStopped() const { return stopped; }
+
+    // The pathfinder's own copy of the map, synced on every Map query
+    const SearchGrid& getGrid() const { return grid; }
+
+    // Nodes popped from the open list(s) by the last query
+    int getNodesExplored() const { return stats.expanded; }
+
+    // Counters, wall time and failure reason of the last query
+    const SearchStats& getLastStats() const { return stats; }
+};
+
+#endif //PATHFINDER_H
@@ -0,0 +1,56 @@
+#ifndef RESERVATIONTABLE_H
+#define RESERVATIONTABLE_H
+
+#include <algorithm>
+#include <vector>
+
+// Which agent holds each (tile, step) over the next few steps, for cooperative planning.
+// A ring of per-step layers: step t lives in layer t % window, so moving the window on
+// only has to empty the layers that fall out of it.
+class ReservationTable {
+    int tiles = 0;
+    int window = 0;
+    int firstStep = 0;              // oldest step still in the window
+    std::vector<int> holder;        // layer * tiles + tile -> agent + 1, 0 when free
+
+    int& cell(int tile, int step) { return holder[static_cast<size_t>(step % window) * tiles + tile]; }
+    int cell(int tile, int step) const { return holder[static_cast<size_t>(step % window) * tiles + tile]; }
+
+public:
+    // Empty table covering steps [0, windowSteps)
+    void reset(int tileCount, int windowSteps) {
+        tiles = tileCount;
+        window = windowSteps;
+        firstStep = 0;
+        holder.assign(static_cast<size_t>(tiles) * window, 0);
+    }
+
+    int getTileCount() const { return tiles; }
+    int getWindow() const { return window; }
+    bool inWindow(int step) const { return step >= firstStep && step < firstStep + window; }
+
+    // Agent holding the tile at that step, or -1 if nobody does (or the step is outside the window)
+    int holderOf(int tile, int step) const { return inWindow(step) ? cell(tile, step) - 1 : -1; }
+    bool isFreeFor(int tile, int step, int agent) const {
+        int current = holderOf(tile, step);
+        return current < 0 || current == agent;
+    }
+
+    // Steps outside the window are ignored
+    void reserve(int tile, int step, int agent) {
+        if (inWindow(step)) cell(tile, step) = agent + 1;
+    }
+    void release(int tile, int step) {
+        if (inWindow(step)) cell(tile, step) = 0;
+    }
+
+    // Drop every step before newFirstStep and make room for the ones after the old window
+    void advanceTo(int newFirstStep) {
+        for (int step = firstStep; step < newFirstStep && step < firstStep + window; ++step) {
+            std::fill_n(holder.begin() + static_cast<size_t>(step % window) * tiles, tiles, 0);
+        }
+        firstStep = newFirstStep;
+    }
+};
+
+#endif //RESERVATIONTABLE_H
@@ -0,0 +1,39 @@
+#ifndef SEARCHGRID_H
+#define SEARCHGRID_H
+
+#include <vector>
+#include <SFML/System.hpp>
+
+class Map;
+
+// What a sync did to the grid
+enum class GridChange {
+    None,     // already up to date
+    Patched,  // only the tiles in changedTiles flipped (one lava spread tick)
+    Rebuilt   // copied from scratch (first sync, regeneration, or missed ticks)
+};
+
+// Flat copy of the map's walkability that the searches read instead of Map.
+// Tiles are addressed by index = y * width + x.
+struct SearchGrid {
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> walkable; // 1 = walkable, 0 = lava
+    unsigned version = ~0u;              // Map version this copy was taken from
+    unsigned layout = ~0u;               // Map layout (regeneration count) it was taken from
+    std::vector<int> changedTiles;       // tiles flipped by the last Patched sync
+
+    // Bring the copy up to date with the map, patching just the spread tiles when possible
+    GridChange syncFrom(const Map& map);
+
+    int tileCount() const { return width * height; }
+    int index(int x, int y) const { return y * width + x; }
+    int index(sf::Vector2i tile) const { return tile.y * width + tile.x; }
+    sf::Vector2i tile(int index) const { return {index % width, index / width}; }
+
+    bool inBounds(int x, int y) const { return x >= 0 && y >= 0 && x < width && y < height; }
+    bool isWalkable(int x, int y) const { return inBounds(x, y) && walkable[y * width + x]; }
+    bool isWalkable(sf::Vector2i tile) const { return isWalkable(tile.x, tile.y); }
+};
+
+#endif //SEARCHGRID_H
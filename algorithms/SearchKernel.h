@@ -0,0 +1,267 @@
+#ifndef SEARCHKERNEL_H
+#define SEARCHKERNEL_H
+
+#include <vector>
+#include <utility>
+#include <functional>
+#include <unordered_map>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <SFML/System.hpp>
+#include "SearchWorkspace.h"
+#include "Landmarks.h"
+
+// One best-first search loop, put together at compile time from policies:
+//   Heuristic   int operator()(x, y): estimate to the goal, in the neighbour policy's cost units
+//   Neighbours  static forEach(grid, x, y, visit): calls visit(nx, ny, stepCost) per open neighbour
+//   OpenList    clear / push(priority, tile) / empty / pop() -> (priority, tile) / size
+//   State       reset / visited / costOf / set / parentOf, e.g. SearchWorkspace or HashMapState
+//   Stats       onExpand / onPush(openSize) / onStalePop, e.g. SearchStats from SearchResult.h
+// Grid is anything with width, height and isWalkable(x, y), such as SearchGrid.
+// Every call is resolved statically, so the inner loop has no virtual calls and no
+// branches on which algorithm is running.
+
+struct NoHeuristic {
+    int operator()(int, int) const { return 0; }
+};
+
+struct ManhattanHeuristic {
+    sf::Vector2i goal;
+    int operator()(int x, int y) const { return std::abs(x - goal.x) + std::abs(y - goal.y); }
+};
+
+// Larger of Manhattan and the landmark bound (ALT)
+struct LandmarkHeuristic {
+    sf::Vector2i goal;
+    const LandmarkTable* landmarks;
+    const uint16_t* goalRow;
+    int width;
+    int operator()(int x, int y) const {
+        return std::max(std::abs(x - goal.x) + std::abs(y - goal.y), landmarks->estimate(y * width + x, goalRow));
+    }
+};
+
+// For EightNeighbours: straight steps cost 10 and diagonal steps 14
+struct OctileHeuristic {
+    sf::Vector2i goal;
+    int operator()(int x, int y) const {
+        int dx = std::abs(x - goal.x);
+        int dy = std::abs(y - goal.y);
+        return 10 * std::max(dx, dy) + 4 * std::min(dx, dy);
+    }
+};
+
+// Up, down, left, right; every step costs 1
+struct FourNeighbours {
+    template <class Grid, class Visit>
+    static void forEach(const Grid& grid, int x, int y, Visit&& visit) {
+        // One call site, so the compiler inlines visit once rather than four times
+        const int dx[4] = {1, -1, 0, 0};
+        const int dy[4] = {0, 0, 1, -1};
+        for (int d = 0; d < 4; ++d) {
+            if (grid.isWalkable(x + dx[d], y + dy[d])) visit(x + dx[d], y + dy[d], 1);
+        }
+    }
+};
+
+// Adds the diagonals, which may not cut a lava corner. Costs 10 straight, 14 diagonal.
+struct EightNeighbours {
+    template <class Grid, class Visit>
+    static void forEach(const Grid& grid, int x, int y, Visit&& visit) {
+        bool right = grid.isWalkable(x + 1, y);
+        bool left = grid.isWalkable(x - 1, y);
+        bool down = grid.isWalkable(x, y + 1);
+        bool up = grid.isWalkable(x, y - 1);
+        if (right) visit(x + 1, y, 10);
+        if (left) visit(x - 1, y, 10);
+        if (down) visit(x, y + 1, 10);
+        if (up) visit(x, y - 1, 10);
+        if (right && down && grid.isWalkable(x + 1, y + 1)) visit(x + 1, y + 1, 14);
+        if (right && up && grid.isWalkable(x + 1, y - 1)) visit(x + 1, y - 1, 14);
+        if (left && down && grid.isWalkable(x - 1, y + 1)) visit(x - 1, y + 1, 14);
+        if (left && up && grid.isWalkable(x - 1, y - 1)) visit(x - 1, y - 1, 14);
+    }
+};
+
+// Binary min-heap of (priority, tile); works with any costs and heuristic
+class BinaryHeapOpen {
+    std::vector<std::pair<int, int>> heap;
+
+public:
+    static constexpr bool settlesOnPush = false;
+    void clear() { heap.clear(); }
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    void push(int priority, int tile) {
+        heap.push_back({priority, tile});
+        std::push_heap(heap.begin(), heap.end(), std::greater<std::pair<int, int>>());
+    }
+    std::pair<int, int> pop() {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<std::pair<int, int>>());
+        auto top = heap.back();
+        heap.pop_back();
+        return top;
+    }
+};
+
+// One bucket per priority, popped LIFO so equal-f ties dive toward the goal. Needs integer
+// priorities that never drop below the last one popped (Dijkstra, or a consistent heuristic).
+// With unit steps and Manhattan only f and f + 2 are ever in use.
+class BucketOpen {
+    std::vector<std::vector<int>> buckets;
+    size_t current = 0;
+    size_t top = 0;   // highest bucket pushed to
+    size_t count = 0;
+
+public:
+    static constexpr bool settlesOnPush = false;
+    void clear() {
+        for (size_t i = current; i <= top && i < buckets.size(); ++i) buckets[i].clear();
+        current = SIZE_MAX;
+        top = 0;
+        count = 0;
+    }
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    void push(int priority, int tile) {
+        size_t bucket = static_cast<size_t>(priority);
+        if (bucket >= buckets.size()) buckets.resize(bucket + 1);
+        buckets[bucket].push_back(tile);
+        current = std::min(current, bucket);
+        top = std::max(top, bucket);
+        count++;
+    }
+    std::pair<int, int> pop() {
+        while (buckets[current].empty()) current++;
+        int tile = buckets[current].back();
+        buckets[current].pop_back();
+        count--;
+        return {static_cast<int>(current), tile};
+    }
+};
+
+// Plain FIFO queue for Dijkstra on unit steps. Tiles leave in order of cost, and the first
+// time a tile is reached is already the cheapest, so the goal is done as soon as it is pushed.
+class FifoOpen {
+    std::vector<int> queue;
+    size_t head = 0;
+
+public:
+    static constexpr bool settlesOnPush = true;
+    void clear() {
+        queue.clear();
+        head = 0;
+    }
+    bool empty() const { return head == queue.size(); }
+    size_t size() const { return queue.size() - head; }
+    void push(int, int tile) { queue.push_back(tile); }
+    std::pair<int, int> pop() { return {0, queue[head++]}; } // nothing goes stale, so no priority is kept
+};
+
+// Per-tile cost and parent in hash maps, as the original Algorithms.h searches kept them.
+// Kept as the baseline the flat SearchWorkspace is measured against.
+class HashMapState {
+    std::unordered_map<int, std::pair<int, int>> entries; // tile -> (cost, parent)
+
+public:
+    void reset(int) { entries.clear(); }
+    bool visited(int tile) const { return entries.count(tile) != 0; }
+    int costOf(int tile) const {
+        auto found = entries.find(tile);
+        return found == entries.end() ? INT_MAX : found->second.first;
+    }
+    int parentOf(int tile) const { return entries.at(tile).second; }
+    void set(int tile, int cost, int from) { entries[tile] = {cost, from}; }
+};
+
+// Counts expansions only, into a counter the caller owns
+struct ExpansionCounter {
+    int& expanded;
+    void onExpand() { expanded++; }
+    void onPush(size_t) {}
+    void onStalePop() {}
+};
+
+// Starts a search at startIndex: fresh state, and only the start on the open list
+template <class Grid, class Heuristic, class OpenList, class State, class Stats>
+void beginSearch(const Grid& grid, int startIndex, const Heuristic& heuristic, OpenList& open, State& state, Stats& stats) {
+    state.reset(grid.width * grid.height);
+    state.set(startIndex, 0, startIndex);
+    open.clear();
+    open.push(heuristic(startIndex % grid.width, startIndex / grid.width), startIndex);
+    stats.onPush(open.size());
+}
+
+// Expands from whatever open and state hold until the goal is reached, the open list
+// runs dry, or stop() returns true. stop() is asked before every pop, so a stopped
+// search loses nothing and can be resumed later with the same open list and state.
+// Returns whether the goal was reached; the path is then in state's parent links.
+template <class Neighbours, class Grid, class Heuristic, class OpenList, class State, class Stats, class Stop>
+bool resumeSearch(const Grid& grid, int goalIndex, const Heuristic& heuristic,
+                  OpenList& open, State& state, Stats& stats, Stop&& stop) {
+    const int width = grid.width;
+    bool found = false;
+    while (!found && !open.empty()) {
+        if (stop()) break;
+        auto [priority, current] = open.pop();
+        int x = current % width;
+        int y = current / width;
+        int cost = state.costOf(current);
+
+        // Stale entry: the tile was reached more cheaply after it was pushed
+        if constexpr (!OpenList::settlesOnPush) {
+            if (priority - heuristic(x, y) > cost) {
+                stats.onStalePop();
+                continue;
+            }
+        }
+
+        stats.onExpand();
+        if (current == goalIndex) {
+            found = true;
+            break;
+        }
+
+        Neighbours::forEach(grid, x, y, [&](int nx, int ny, int stepCost) {
+            int next = ny * width + nx;
+            int newCost = cost + stepCost;
+            if constexpr (OpenList::settlesOnPush) {
+                // The first visit is the cheapest one
+                if (state.visited(next)) return;
+                state.set(next, newCost, current);
+                if (next == goalIndex) found = true;
+            } else {
+                if (newCost >= state.costOf(next)) return;
+                state.set(next, newCost, current);
+            }
+            open.push(newCost + heuristic(nx, ny), next);
+            stats.onPush(open.size());
+        });
+    }
+    return found;
+}
+
+// Searches from startIndex to goalIndex in one go and returns whether the goal was reached
+template <class Neighbours, class Grid, class Heuristic, class OpenList, class State, class Stats, class Stop>
+bool runSearch(const Grid& grid, int startIndex, int goalIndex, const Heuristic& heuristic,
+               OpenList& open, State& state, Stats& stats, Stop&& stop) {
+    beginSearch(grid, startIndex, heuristic, open, state, stats);
+    if (startIndex == goalIndex) return true;
+    return resumeSearch<Neighbours>(grid, goalIndex, heuristic, open, state, stats, stop);
+}
+
+// Tiles from start to goal along state's parent links, after runSearch found the goal
+template <class Grid, class State>
+std::vector<sf::Vector2i> tracePath(const Grid& grid, const State& state, int startIndex, int goalIndex) {
+    std::vector<sf::Vector2i> path;
+    for (int tile = goalIndex; tile != startIndex; tile = state.parentOf(tile)) {
+        path.push_back({tile % grid.width, tile / grid.width});
+    }
+    path.push_back({startIndex % grid.width, startIndex / grid.width});
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+#endif //SEARCHKERNEL_H
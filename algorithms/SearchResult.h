@@ -0,0 +1,54 @@
+#ifndef SEARCHRESULT_H
+#define SEARCHRESULT_H
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+#include <SFML/System.hpp>
+
+// Why a search came back without a path
+enum class SearchFailure {
+    None,          // found a path
+    StartBlocked,  // the start tile is lava or off the map
+    GoalBlocked,   // the goal tile is lava or off the map
+    Unreachable,   // the open list ran dry
+    Stopped,       // cancelled or out of time
+    Outdated       // a precomputed answer crosses lava that spread after it was made
+};
+
+// Counters for one query. Also the stats policy the search kernel fills in as it runs.
+struct SearchStats {
+    SearchFailure failure = SearchFailure::None;
+    int expanded = 0;   // tiles popped and expanded
+    int pushed = 0;     // open-list insertions
+    int stalePops = 0;  // popped entries already superseded by a cheaper cost
+    int peakOpen = 0;   // largest open-list size
+    double wallMs = 0;
+
+    void onExpand() { expanded++; }
+    void onPush(size_t openSize) {
+        pushed++;
+        peakOpen = std::max(peakOpen, static_cast<int>(openSize));
+    }
+    void onStalePop() { stalePops++; }
+};
+
+struct SearchResult {
+    std::vector<sf::Vector2i> path;
+    SearchStats stats;
+
+    bool found() const { return stats.failure == SearchFailure::None; }
+};
+
+std::string failureText(SearchFailure failure);
+
+// One line per group, e.g. "652 expanded, 1301 pushed\n3 stale pops, peak open 90\n0.05 ms"
+std::string describeSearch(const SearchStats& stats);
+
+// Searches don't print. Install a sink to have them report each query; pass nullptr to stop.
+void setSearchLog(std::function<void(const std::string&)> sink);
+void logSearch(const std::string& line);
+bool searchLogEnabled();
+
+#endif //SEARCHRESULT_H
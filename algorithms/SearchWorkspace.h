@@ -0,0 +1,43 @@
+#ifndef SEARCHWORKSPACE_H
+#define SEARCHWORKSPACE_H
+
+#include <vector>
+#include <climits>
+#include <algorithm>
+
+// Per-tile search state kept in flat arrays and reused between queries.
+// Instead of clearing every array, each query bumps a generation number; a tile
+// whose stamp doesn't match the current generation counts as unvisited.
+class SearchWorkspace {
+    std::vector<unsigned> stamp;
+    std::vector<int> cost;
+    std::vector<int> parent;
+    unsigned generation = 0;
+
+public:
+    // Start a new query over tileCount tiles. O(1) unless the grid grew or the generation wrapped.
+    void reset(int tileCount) {
+        if (static_cast<int>(stamp.size()) < tileCount) {
+            stamp.assign(tileCount, 0);
+            cost.resize(tileCount);
+            parent.resize(tileCount);
+            generation = 0;
+        }
+        if (++generation == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            generation = 1;
+        }
+    }
+
+    bool visited(int tile) const { return stamp[tile] == generation; }
+    int costOf(int tile) const { return visited(tile) ? cost[tile] : INT_MAX; }
+    int parentOf(int tile) const { return parent[tile]; }
+
+    void set(int tile, int newCost, int from) {
+        stamp[tile] = generation;
+        cost[tile] = newCost;
+        parent[tile] = from;
+    }
+};
+
+#endif //SEARCHWORKSPACE_H
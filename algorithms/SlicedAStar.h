@@ -0,0 +1,81 @@
+#ifndef SLICEDASTAR_H
+#define SLICEDASTAR_H
+
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <vector>
+#include <SFML/System.hpp>
+#include "SearchGrid.h"
+#include "SearchWorkspace.h"
+#include "SearchKernel.h"
+#include "SearchResult.h"
+#include "../UI-UX/Map.h"
+
+// A* that runs for a fixed time per call. The open list and costs stay in the object
+// between slices, so a long search is spread over frames instead of stalling one.
+class SlicedAStar {
+    // SearchWorkspace that also keeps the reached tile nearest the goal, to show progress
+    struct TrackedState {
+        SearchWorkspace costs;
+        int width = 0;
+        sf::Vector2i goal;
+        int nearest = 0;
+        int nearestEstimate = INT_MAX;
+
+        void reset(int tileCount) {
+            costs.reset(tileCount);
+            nearestEstimate = INT_MAX;
+        }
+        bool visited(int tile) const { return costs.visited(tile); }
+        int costOf(int tile) const { return costs.costOf(tile); }
+        int parentOf(int tile) const { return costs.parentOf(tile); }
+        void set(int tile, int cost, int from) {
+            costs.set(tile, cost, from);
+            int estimate = std::abs(tile % width - goal.x) + std::abs(tile / width - goal.y);
+            if (estimate < nearestEstimate) {
+                nearestEstimate = estimate;
+                nearest = tile;
+            }
+        }
+    };
+
+    SearchGrid grid;
+    TrackedState state;
+    BinaryHeapOpen open;
+    SearchStats stats;                // summed over every slice
+    sf::Vector2i start;
+    sf::Vector2i goal;
+    int startIndex = 0;
+    int goalIndex = 0;
+    int startEstimate = 0;
+    int slices = 0;
+    bool searching = false;
+    std::vector<sf::Vector2i> path;
+
+public:
+    // Set up a search without expanding anything. Returns false if start or goal is lava;
+    // getStats() then says which.
+    bool begin(const Map& map, sf::Vector2i from, sf::Vector2i destination);
+    void cancel() { searching = false; }
+    bool isSearching() const { return searching; }
+
+    // Feed this tick's lava. Starts again from the NaviGator's tile if lava landed on a
+    // tile the search already reached. Returns true if it started over.
+    bool sync(const Map& map, sf::Vector2i from);
+
+    // Search for at most budget. Returns true once the search is over, found or not.
+    bool step(std::chrono::microseconds budget);
+
+    // How much of the start's distance to the goal the nearest reached tile has covered, 0 to 1
+    float getProgress() const;
+    // Best route so far: from the start to the reached tile nearest the goal
+    std::vector<sf::Vector2i> getProbe() const;
+
+    sf::Vector2i getGoal() const { return goal; }
+    int getSlices() const { return slices; }
+    const std::vector<sf::Vector2i>& getPath() const { return path; }
+    const SearchStats& getStats() const { return stats; }
+};
+
+#endif //SLICEDASTAR_H
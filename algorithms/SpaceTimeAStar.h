@@ -0,0 +1,41 @@
+#ifndef SPACETIMEASTAR_H
+#define SPACETIMEASTAR_H
+
+#include <chrono>
+#include <vector>
+#include <SFML/System.hpp>
+#include "LavaForecast.h"
+#include "SearchKernel.h"
+#include "SearchWorkspace.h"
+#include "SearchResult.h"
+
+// A* over (tile, arrival time) that only steps onto a tile if the NaviGator can be off it
+// again before the lava forecast says lava could get there. Lava never recedes, so
+// reaching a tile earlier is always at least as good as reaching it later: each tile
+// keeps only its earliest arrival, and the time-expanded graph needs one state per tile.
+// Waiting is never useful for the same reason, so there is no wait move.
+class SpaceTimeAStar {
+    SearchWorkspace workspace;      // earliest arrival (in steps) and parent of every tile
+    BinaryHeapOpen open;
+    float secondsPerStep = 1.f / 15.f;
+    float marginSeconds = 0.5f;     // extra time to be off a tile before lava could arrive
+    int lavaPruned = 0;             // moves dropped because lava could beat the NaviGator there
+    float slackSeconds = 0.f;
+
+public:
+    // How fast the NaviGator walks, and how much spare time each tile must leave
+    void setTilesPerSecond(float tilesPerSecond) { secondsPerStep = 1.f / tilesPerSecond; }
+    void setMarginSeconds(float seconds) { marginSeconds = seconds; }
+
+    // Shortest path that stays ahead of the forecast lava. Stops with SearchFailure::Stopped
+    // once budget is used up.
+    SearchResult findPath(const LavaForecast& forecast, sf::Vector2i start, sf::Vector2i goal,
+                          std::chrono::microseconds budget = std::chrono::microseconds::max());
+
+    // Moves the last search refused because of lava
+    int getLavaPruned() const { return lavaPruned; }
+    // Least time any tile on the last path had to spare before lava could reach it
+    float getSlackSeconds() const { return slackSeconds; }
+};
+
+#endif //SPACETIMEASTAR_H
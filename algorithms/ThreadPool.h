@@ -0,0 +1,45 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads kept alive between jobs. parallelFor hands out indices
+// one at a time, so uneven work (short and long path queries) still balances.
+class ThreadPool {
+    std::vector<std::thread> workers;
+
+    std::mutex jobMutex; // guards job, generation, busy and stopping
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const std::function<void(size_t, unsigned)>* job = nullptr;
+    size_t jobSize = 0;
+    std::atomic<size_t> nextIndex{0};
+    unsigned generation = 0;
+    unsigned busy = 0;
+    bool stopping = false;
+
+    void run(unsigned worker);
+    void work(unsigned worker);
+
+public:
+    // threadCount includes the calling thread, which works too; 0 means one per core
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    // Calls fn(index, worker) for every index in [0, count) and returns once all are done.
+    // worker is in [0, size()) and no two calls with the same worker run at once,
+    // so it can pick per-thread state.
+    void parallelFor(size_t count, const std::function<void(size_t index, unsigned worker)>& fn);
+};
+
+#endif //THREADPOOL_H
@@ -1,184 +1,67 @@
 #include "Algorithms.h"
-#include <queue>
-#include <unordered_map>
-#include <cmath>
-#include <algorithm>
-#include <iostream>
+#include "SearchKernel.h"
+#include <chrono>
+#include <sstream>
 
 using namespace std;
 
-// This hash function definition is also in LavaGenerator.h, but we need it here too
-struct Vector2iHash1 {
-    size_t operator()(const sf::Vector2i& v) const {
-        size_t xHash = hash<int>()(v.x);
-        size_t yHash = hash<int>()(v.y);
-        return xHash ^ (yHash << 1);
-    }
-};
-
-int heuristic(const sf::Vector2i& a, const sf::Vector2i& b) {
-    return abs(a.x - b.x) + abs(a.y - b.y); // Manhattan distance
-}
+namespace {
 
-struct CompareCost {
-    bool operator()(const pair<int, sf::Vector2i>& a, const pair<int, sf::Vector2i>& b) {
-        return a.first > b.first; // Min-heap based on cost
+// Reads walkability straight from the Map, as these searches always have
+struct MapGrid {
+    const Map& map;
+    int width;
+    int height;
+    bool isWalkable(int x, int y) const {
+        return x >= 0 && y >= 0 && x < width && y < height && map.isWalkable(x, y);
     }
 };
 
-vector<sf::Vector2i> findDijkstraPath(const Map& map, sf::Vector2i start, sf::Vector2i goal) {
-    cout << "Finding Dijkstra path from (" << start.x << "," << start.y
-         << ") to (" << goal.x << "," << goal.y << ")" << endl;
+// Both searches are the shared kernel with hash-map state and a binary heap; they stay the
+// baseline the Pathfinder engines are benchmarked against
+template <class Heuristic>
+SearchResult searchMap(const Map& map, sf::Vector2i start, sf::Vector2i goal, const Heuristic& heuristic, const string& name) {
+    auto begin = chrono::steady_clock::now();
+    SearchResult result;
+    SearchStats& stats = result.stats;
 
     // Check if start or goal is unwalkable
-    if (!map.isWalkable(start.x, start.y) || !map.isWalkable(goal.x, goal.y)) {
-        cout << "Start or goal is not walkable!" << endl;
-        return vector<sf::Vector2i>(); // Return empty path
-    }
-
-    priority_queue<pair<int, sf::Vector2i>, vector<pair<int, sf::Vector2i>>, CompareCost> frontier;
-    frontier.push({0, start});
-
-    unordered_map<sf::Vector2i, sf::Vector2i, Vector2iHash1> cameFrom;
-    unordered_map<sf::Vector2i, int, Vector2iHash1> costSoFar;
-
-    cameFrom[start] = start;
-    costSoFar[start] = 0;
-
-    vector<sf::Vector2i> directions = {
-        {1, 0}, {-1, 0}, {0, 1}, {0, -1}
-    };
-
-    int nodesExplored = 0;
-    bool pathFound = false;
-
-    while (!frontier.empty()) {
-        sf::Vector2i current = frontier.top().second;
-        frontier.pop();
-        nodesExplored++;
-
-        if (current == goal) {
-            pathFound = true;
-            break;
-        }
-
-        for (const auto& dir : directions) {
-            sf::Vector2i next = current + dir;
-
-            // Skip if out of bounds or unwalkable (e.g., lava)
-            if (next.x < 0 || next.y < 0 || next.x >= map.getWidth() || next.y >= map.getHeight() ||
-                !map.isWalkable(next.x, next.y)) {
-                continue;
-
-            if (map.isLava(next.x, next.y))
-                continue;
-            }
-
-            int newCost = costSoFar[current] + 1;
-
-            if (costSoFar.find(next) == costSoFar.end() || newCost < costSoFar[next]) {
-                costSoFar[next] = newCost;
-                frontier.push({newCost, next});
-                cameFrom[next] = current;
-            }
+    if (!map.isWalkable(start.x, start.y)) {
+        stats.failure = SearchFailure::StartBlocked;
+    } else if (!map.isWalkable(goal.x, goal.y)) {
+        stats.failure = SearchFailure::GoalBlocked;
+    } else {
+        MapGrid grid{map, map.getWidth(), map.getHeight()};
+        int startIndex = start.y * grid.width + start.x;
+        int goalIndex = goal.y * grid.width + goal.x;
+
+        BinaryHeapOpen frontier;
+        HashMapState state;
+        if (runSearch<FourNeighbours>(grid, startIndex, goalIndex, heuristic, frontier, state, stats, [] { return false; })) {
+            result.path = tracePath(grid, state, startIndex, goalIndex);
+        } else {
+            stats.failure = SearchFailure::Unreachable;
         }
     }
-
-    vector<sf::Vector2i> path;
-    if (!pathFound) {
-        cout << "Dijkstra: No path found after exploring " << nodesExplored << " nodes" << endl;
-        return path;
-    }
-
-    sf::Vector2i current = goal;
-    while (current != start) {
-        path.push_back(current);
-        current = cameFrom[current];
+    stats.wallMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+
+    if (searchLogEnabled()) {
+        stringstream ss;
+        ss << name << " (" << start.x << "," << start.y << ") -> (" << goal.x << "," << goal.y << "): "
+           << failureText(stats.failure);
+        if (result.found()) ss << ", " << result.path.size() << " steps";
+        ss << "\n" << describeSearch(stats);
+        logSearch(ss.str());
     }
-
-    path.push_back(start);
-    reverse(path.begin(), path.end());
-
-    cout << "Dijkstra: Path found with " << path.size() << " steps after exploring "
-         << nodesExplored << " nodes" << endl;
-
-    return path;
+    return result;
 }
 
-vector<sf::Vector2i> findAStarPath(const Map& map, sf::Vector2i start, sf::Vector2i goal) {
-    cout << "Finding A* path from (" << start.x << "," << start.y
-         << ") to (" << goal.x << "," << goal.y << ")" << endl;
+} // namespace
 
-    // Check if start or goal is unwalkable
-    if (!map.isWalkable(start.x, start.y) || !map.isWalkable(goal.x, goal.y)) {
-        cout << "Start or goal is not walkable!" << endl;
-        return vector<sf::Vector2i>(); // Return empty path
-    }
-
-    priority_queue<pair<int, sf::Vector2i>, vector<pair<int, sf::Vector2i>>, CompareCost> frontier;
-    int startPriority = heuristic(start, goal);
-    frontier.push({startPriority, start});
-
-    unordered_map<sf::Vector2i, sf::Vector2i, Vector2iHash1> cameFrom;
-    unordered_map<sf::Vector2i, int, Vector2iHash1> costSoFar;
-
-    cameFrom[start] = start;
-    costSoFar[start] = 0;
-
-    vector<sf::Vector2i> directions = {
-        {1, 0}, {-1, 0}, {0, 1}, {0, -1}
-    };
-
-    int nodesExplored = 0;
-    bool pathFound = false;
-
-    while (!frontier.empty()) {
-        sf::Vector2i current = frontier.top().second;
-        frontier.pop();
-        nodesExplored++;
-
-        if (current == goal) {
-            pathFound = true;
-            break;
-        }
-
-        for (const auto& dir : directions) {
-            sf::Vector2i next = current + dir;
-
-            // Skip if out of bounds or unwalkable (e.g., lava)
-            if (next.x < 0 || next.y < 0 || next.x >= map.getWidth() || next.y >= map.getHeight() ||
-                !map.isWalkable(next.x, next.y)) {
-                continue;
-            }
-
-            int newCost = costSoFar[current] + 1;
-
-            if (costSoFar.find(next) == costSoFar.end() || newCost < costSoFar[next]) {
-                costSoFar[next] = newCost;
-                int priority = newCost + heuristic(next, goal);
-                frontier.push({priority, next});
-                cameFrom[next] = current;
-            }
-        }
-    }
-
-    vector<sf::Vector2i> path;
-    if (!pathFound) {
-        cout << "A*: No path found after exploring " << nodesExplored << " nodes" << endl;
-        return path;
-    }
-
-    sf::Vector2i current = goal;
-    while (current != start) {
-        path.push_back(current);
-        current = cameFrom[current];
-    }
-
-    path.push_back(start);
-    reverse(path.begin(), path.end());
-
-    cout << "A*: Path found with " << path.size() << " steps after exploring "
-         << nodesExplored << " nodes" << endl;
+SearchResult findDijkstraPath(const Map& map, sf::Vector2i start, sf::Vector2i goal) {
+    return searchMap(map, start, goal, NoHeuristic{}, "Dijkstra");
+}
 
-    return path;
-}
\ No newline at end of file
+SearchResult findAStarPath(const Map& map, sf::Vector2i start, sf::Vector2i goal) {
+    return searchMap(map, start, goal, ManhattanHeuristic{goal}, "A*");
+}
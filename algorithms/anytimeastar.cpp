@@ -0,0 +1,176 @@
+#include "AnytimeAStar.h"
+#include "SearchKernel.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <functional>
+
+using namespace std;
+
+int AnytimeAStar::heuristic(int tile) const {
+    return abs(tile % grid.width - goal.x) + abs(tile / grid.width - goal.y);
+}
+
+void AnytimeAStar::push(int tile) {
+    open.push_back({keyOf(tile), tile});
+    push_heap(open.begin(), open.end(), greater<pair<int, int>>());
+    stats.onPush(open.size());
+}
+
+void AnytimeAStar::plan(const Map& map, sf::Vector2i from, sf::Vector2i destination, int firstWeight) {
+    grid.syncFrom(map);
+    int count = grid.tileCount();
+    costs.reset(count);
+    closedIn.assign(count, 0);
+    inconsIn.assign(count, 0);
+    incons.clear();
+    open.clear();
+    pass = 1;
+
+    start = from;
+    goal = destination;
+    initialWeight = weight = max(10, firstWeight);
+    active = true;
+    finished = false;
+    path.clear();
+    bound = 0;
+    stats = SearchStats();
+
+    if (!grid.isWalkable(start) || !grid.isWalkable(goal)) {
+        stats.failure = grid.isWalkable(start) ? SearchFailure::GoalBlocked : SearchFailure::StartBlocked;
+        finished = true;
+        return;
+    }
+    startIndex = grid.index(start);
+    goalIndex = grid.index(goal);
+    costs.set(startIndex, 0, startIndex);
+    push(startIndex);
+}
+
+// Expands until nothing on the open list could beat the goal's cost at the current weight
+AnytimeAStar::PassResult AnytimeAStar::improvePath(chrono::steady_clock::time_point deadline) {
+    const int dx[4] = {1, -1, 0, 0};
+    const int dy[4] = {0, 0, 1, -1};
+    int sinceClockCheck = 0;
+
+    while (!open.empty()) {
+        int goalCost = costs.costOf(goalIndex);
+        if (goalCost != INT_MAX && open.front().first >= 10 * goalCost) return PassResult::Solved;
+
+        pop_heap(open.begin(), open.end(), greater<pair<int, int>>());
+        auto [key, tile] = open.back();
+        open.pop_back();
+        if (closedIn[tile] == pass || key != keyOf(tile)) {
+            stats.onStalePop();
+            continue;
+        }
+        closedIn[tile] = pass;
+        stats.onExpand();
+
+        int x = tile % grid.width;
+        int y = tile / grid.width;
+        int newCost = costs.costOf(tile) + 1;
+        for (int d = 0; d < 4; ++d) {
+            if (!grid.isWalkable(x + dx[d], y + dy[d])) continue;
+            int next = grid.index(x + dx[d], y + dy[d]);
+            if (newCost >= costs.costOf(next)) continue;
+            costs.set(next, newCost, tile);
+            if (closedIn[next] != pass) {
+                push(next);
+            } else if (inconsIn[next] != pass) {
+                // Already expanded this pass; it waits for the next one
+                inconsIn[next] = pass;
+                incons.push_back(next);
+            }
+        }
+
+        // Reading the clock costs about as much as an expansion, so only do it now and then
+        if (++sinceClockCheck == 256) {
+            sinceClockCheck = 0;
+            if (chrono::steady_clock::now() >= deadline) return PassResult::OutOfTime;
+        }
+    }
+    return costs.costOf(goalIndex) == INT_MAX ? PassResult::Exhausted : PassResult::Solved;
+}
+
+// Takes the path out of the parent links, and bounds it by the cheapest g + h still
+// waiting, since the shortest path has to pass through one of those tiles
+void AnytimeAStar::publish() {
+    path = tracePath(grid, costs, startIndex, goalIndex);
+
+    int goalCost = costs.costOf(goalIndex);
+    int lowest = INT_MAX;
+    for (const auto& [key, tile] : open) {
+        if (closedIn[tile] != pass && key == keyOf(tile)) lowest = min(lowest, costs.costOf(tile) + heuristic(tile));
+    }
+    for (int tile : incons) lowest = min(lowest, costs.costOf(tile) + heuristic(tile));
+
+    bound = lowest >= goalCost ? 1.0 : min(weight / 10.0, static_cast<double>(goalCost) / lowest);
+}
+
+// Lowers the weight and re-keys the tiles still waiting: the open list minus its stale
+// entries, plus INCONS. Nothing else is touched, so the costs found so far carry over.
+void AnytimeAStar::beginPass() {
+    size_t kept = 0;
+    for (const auto& entry : open) {
+        if (closedIn[entry.second] != pass && entry.first == keyOf(entry.second)) open[kept++] = entry;
+    }
+    open.resize(kept);
+    for (int tile : incons) open.push_back({0, tile});
+    incons.clear();
+
+    weight = max(10, weight - 5);
+    pass++;
+    for (auto& entry : open) entry.first = keyOf(entry.second);
+    make_heap(open.begin(), open.end(), greater<pair<int, int>>());
+}
+
+bool AnytimeAStar::step(chrono::microseconds budget) {
+    if (!active || finished) return false;
+
+    auto began = chrono::steady_clock::now();
+    auto deadline = began + budget;
+    bool improved = false;
+    while (!finished) {
+        PassResult result = improvePath(deadline);
+        if (result == PassResult::OutOfTime) break;
+        if (result == PassResult::Exhausted) {
+            stats.failure = SearchFailure::Unreachable;
+            finished = true;
+            break;
+        }
+
+        publish();
+        improved = true;
+        if (weight == 10 || bound <= 1.0) {
+            finished = true;
+            break;
+        }
+        beginPass();
+        if (chrono::steady_clock::now() >= deadline) break;
+    }
+    stats.wallMs += chrono::duration<double, milli>(chrono::steady_clock::now() - began).count();
+    return improved;
+}
+
+bool AnytimeAStar::sync(const Map& map, sf::Vector2i from) {
+    if (!active) return false;
+
+    GridChange change = grid.syncFrom(map);
+    if (change == GridChange::None) return false;
+
+    // Lava only closes tiles, so a finished path it missed is still as good as its bound says
+    bool hit = change == GridChange::Rebuilt;
+    for (sf::Vector2i tile : path) {
+        if (!grid.isWalkable(tile)) hit = true;
+    }
+    if (!finished) {
+        for (int tile : grid.changedTiles) {
+            if (costs.visited(tile)) hit = true;
+        }
+    }
+    if (!hit) return false;
+
+    plan(map, from, goal, initialWeight);
+    return true;
+}
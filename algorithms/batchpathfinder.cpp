@@ -0,0 +1,23 @@
+#include "BatchPathfinder.h"
+#include <chrono>
+
+using namespace std;
+
+BatchPathfinder::BatchPathfinder(unsigned threadCount) : pool(threadCount), pathfinders(pool.size()) {}
+
+vector<BatchResult> BatchPathfinder::findAStarPaths(const Map& map, const BatchQuery* queries, size_t count) {
+    grid.syncFrom(map);
+    return findAStarPaths(grid, queries, count);
+}
+
+vector<BatchResult> BatchPathfinder::findAStarPaths(const SearchGrid& searchGrid, const BatchQuery* queries, size_t count) {
+    vector<BatchResult> results(count);
+    pool.parallelFor(count, [&](size_t i, unsigned worker) {
+        Pathfinder& pathfinder = pathfinders[worker];
+        auto begin = chrono::steady_clock::now();
+        results[i].path = pathfinder.findAStarPath(searchGrid, queries[i].start, queries[i].goal);
+        results[i].searchUs = chrono::duration<float, micro>(chrono::steady_clock::now() - begin).count();
+        results[i].nodesExplored = pathfinder.getNodesExplored();
+    });
+    return results;
+}
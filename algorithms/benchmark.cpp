@@ -0,0 +1,394 @@
+#include "Benchmark.h"
+#include "Algorithms.h"
+#include "Pathfinder.h"
+#include "SearchKernel.h"
+#include "HierarchicalPathfinder.h"
+#include "BatchPathfinder.h"
+#include "ContractionHierarchy.h"
+#include "BitParallelBfs.h"
+#include "FlowField.h"
+#include "LavaForecast.h"
+#include "SpaceTimeAStar.h"
+#include "CooperativePlanner.h"
+#include "FirstMoveTable.h"
+#include "HashDistributedAStar.h"
+#include "SearchWorkspace.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+class BenchmarkTable {
+    const vector<BatchQuery>& queries;
+    vector<size_t> referenceLengths;
+    double baselineMs = 0;
+
+public:
+    explicit BenchmarkTable(const vector<BatchQuery>& q) : queries(q) {
+        cout << left << setw(28) << "engine" << right << setw(12) << "total ms"
+             << setw(14) << "us/query" << setw(10) << "speedup" << setw(12) << "mismatch" << setw(14) << "expanded" << endl;
+    }
+
+    // Runs fn on every query and reports its speedup over the current baseline.
+    // Path lengths are always checked against the very first row.
+    void row(const string& name, const function<vector<sf::Vector2i>(sf::Vector2i, sf::Vector2i)>& fn,
+             const function<int()>& expanded = nullptr, bool isBaseline = false) {
+        vector<size_t> lengths;
+        lengths.reserve(queries.size());
+        long long totalExpanded = 0;
+        auto begin = chrono::steady_clock::now();
+        for (const auto& q : queries) {
+            lengths.push_back(fn(q.start, q.goal).size());
+            if (expanded) totalExpanded += expanded();
+        }
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+        report(name, lengths, ms, expanded ? totalExpanded : -1, isBaseline);
+    }
+
+    // Same, for an engine that answers all the queries in one call
+    void batchRow(const string& name, const function<vector<BatchResult>(const vector<BatchQuery>&)>& fn) {
+        auto begin = chrono::steady_clock::now();
+        vector<BatchResult> results = fn(queries);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+
+        vector<size_t> lengths;
+        long long totalExpanded = 0;
+        for (const auto& result : results) {
+            lengths.push_back(result.path.size());
+            totalExpanded += result.nodesExplored;
+        }
+        report(name, lengths, ms, totalExpanded, false);
+    }
+
+private:
+    void report(const string& name, const vector<size_t>& lengths, double ms, long long totalExpanded, bool isBaseline) {
+        if (referenceLengths.empty()) referenceLengths = lengths;
+        if (isBaseline || baselineMs == 0) baselineMs = ms;
+        int mismatches = 0;
+        for (size_t i = 0; i < lengths.size(); ++i) {
+            if (lengths[i] != referenceLengths[i]) mismatches++;
+        }
+
+        cout << left << setw(28) << name << right << fixed << setprecision(2) << setw(12) << ms
+             << setw(14) << (ms * 1000.0 / queries.size()) << setw(9) << (ms > 0 ? baselineMs / ms : 0) << "x"
+             << setw(12) << mismatches;
+        if (totalExpanded >= 0) cout << setw(14) << totalExpanded / static_cast<long long>(queries.size());
+        else cout << setw(14) << "-";
+        cout << endl;
+    }
+};
+
+// The heap A* loop Pathfinder had before the search kernel, kept written out by hand so
+// the kernel's "A* (workspace heap)" row has something to be measured against
+class HandWrittenAStar {
+    SearchWorkspace workspace;
+    vector<pair<int, int>> open;
+
+public:
+    int expanded = 0;
+
+    vector<sf::Vector2i> findPath(const SearchGrid& grid, sf::Vector2i start, sf::Vector2i goal) {
+        expanded = 0;
+        if (!grid.isWalkable(start) || !grid.isWalkable(goal)) return {};
+        const int startIndex = grid.index(start);
+        const int goalIndex = grid.index(goal);
+        const int dx[4] = {1, -1, 0, 0};
+        const int dy[4] = {0, 0, 1, -1};
+        const greater<pair<int, int>> minHeap;
+        auto heuristic = [&](int x, int y) { return abs(x - goal.x) + abs(y - goal.y); };
+
+        workspace.reset(grid.tileCount());
+        workspace.set(startIndex, 0, startIndex);
+        open.clear();
+        open.push_back({heuristic(start.x, start.y), startIndex});
+        bool found = false;
+        while (!open.empty()) {
+            pop_heap(open.begin(), open.end(), minHeap);
+            auto [priority, current] = open.back();
+            open.pop_back();
+            int x = current % grid.width;
+            int y = current / grid.width;
+            int cost = workspace.costOf(current);
+            if (priority - heuristic(x, y) > cost) continue;
+            expanded++;
+            if (current == goalIndex) {
+                found = true;
+                break;
+            }
+            for (int d = 0; d < 4; ++d) {
+                int nx = x + dx[d];
+                int ny = y + dy[d];
+                if (!grid.isWalkable(nx, ny)) continue;
+                int next = ny * grid.width + nx;
+                if (cost + 1 < workspace.costOf(next)) {
+                    workspace.set(next, cost + 1, current);
+                    open.push_back({cost + 1 + heuristic(nx, ny), next});
+                    push_heap(open.begin(), open.end(), minHeap);
+                }
+            }
+        }
+        if (!found) return {};
+        vector<sf::Vector2i> path;
+        for (int tile = goalIndex; tile != startIndex; tile = workspace.parentOf(tile)) path.push_back(grid.tile(tile));
+        path.push_back(start);
+        reverse(path.begin(), path.end());
+        return path;
+    }
+};
+
+// Square map with lava pools of random sizes dropped on it until about 30% is lava
+SearchGrid makeLavaField(int size, mt19937& rng) {
+    SearchGrid grid;
+    grid.width = size;
+    grid.height = size;
+    grid.walkable.assign(static_cast<size_t>(size) * size, 1);
+    uniform_int_distribution<int> coordinate(0, size - 1);
+    uniform_int_distribution<int> radius(4, 40);
+    long long lava = 0;
+    while (lava * 10 < static_cast<long long>(grid.tileCount()) * 3) {
+        int cx = coordinate(rng), cy = coordinate(rng), r = radius(rng);
+        for (int y = max(0, cy - r); y <= min(size - 1, cy + r); ++y) {
+            for (int x = max(0, cx - r); x <= min(size - 1, cx + r); ++x) {
+                if ((x - cx) * (x - cx) + (y - cy) * (y - cy) > r * r) continue;
+                unsigned char& tile = grid.walkable[grid.index(x, y)];
+                lava += tile;
+                tile = 0;
+            }
+        }
+    }
+    return grid;
+}
+
+// Tiles reachable from the walkable tile nearest the middle, so benchmark queries never flood the map in vain
+vector<unsigned char> mainRegion(const SearchGrid& grid) {
+    vector<unsigned char> reached(grid.tileCount(), 0);
+    int seed = grid.index(grid.width / 2, grid.height / 2);
+    while (seed < grid.tileCount() && !grid.walkable[seed]) seed++;
+    if (seed == grid.tileCount()) return reached;
+    const int dx[4] = {1, -1, 0, 0};
+    const int dy[4] = {0, 0, 1, -1};
+    vector<int> queue{seed};
+    reached[seed] = 1;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        sf::Vector2i t = grid.tile(queue[head]);
+        for (int d = 0; d < 4; ++d) {
+            if (!grid.isWalkable(t.x + dx[d], t.y + dy[d])) continue;
+            int next = grid.index(t.x + dx[d], t.y + dy[d]);
+            if (reached[next]) continue;
+            reached[next] = 1;
+            queue.push_back(next);
+        }
+    }
+    return reached;
+}
+
+} // namespace
+
+void runParallelSearchBenchmark(int size, int queryCount, unsigned seed) {
+    mt19937 rng(seed);
+    SearchGrid grid = makeLavaField(size, rng);
+    vector<unsigned char> reached = mainRegion(grid);
+
+    // Long queries inside one region: opposite halves of the map
+    vector<BatchQuery> queries;
+    uniform_int_distribution<int> coordinate(0, size - 1);
+    int attempts = 0;
+    while (static_cast<int>(queries.size()) < queryCount && attempts++ < queryCount * 10000) {
+        sf::Vector2i a(coordinate(rng), coordinate(rng));
+        sf::Vector2i b(coordinate(rng), coordinate(rng));
+        if (abs(a.x - b.x) + abs(a.y - b.y) >= size && reached[grid.index(a)] && reached[grid.index(b)]) queries.push_back({a, b});
+    }
+    cout << "Parallel A*: " << queries.size() << " queries at least " << size << " tiles apart on a synthetic "
+         << size << "x" << size << " lava map" << endl;
+    if (queries.empty()) return;
+
+    BenchmarkTable table(queries);
+    {
+        Pathfinder pathfinder;
+        pathfinder.setUnitCostEngine(false);
+        table.row("A* (workspace heap)", [&](sf::Vector2i s, sf::Vector2i g) { return pathfinder.findAStarPath(grid, s, g); },
+                  [&] { return pathfinder.getNodesExplored(); }, true);
+    }
+
+    // 1, 2, 4, ... threads, and one per core
+    vector<unsigned> threadCounts;
+    unsigned cores = max(1u, thread::hardware_concurrency());
+    for (unsigned threads = 1; threads < cores; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(cores);
+    for (unsigned threads : threadCounts) {
+        HashDistributedAStar hda(threads);
+        SearchResult found;
+        long long sent = 0;
+        table.row("HDA* (" + to_string(threads) + " threads)", [&](sf::Vector2i s, sf::Vector2i g) {
+            found = hda.findPath(grid, s, g);
+            sent += hda.getMessages();
+            return found.path;
+        }, [&] { return found.stats.expanded; });
+        cout << "    " << sent / static_cast<long long>(queries.size()) << " tiles sent between threads per query" << endl;
+    }
+}
+
+void runPathBenchmark(const Map& map, int queryCount, unsigned seed, const FirstMoveTable* firstMoves) {
+    SearchGrid grid;
+    grid.syncFrom(map);
+
+    vector<BatchQuery> queries;
+    mt19937 rng(seed);
+    uniform_int_distribution<int> randX(0, max(0, grid.width - 1));
+    uniform_int_distribution<int> randY(0, max(0, grid.height - 1));
+
+    int attempts = 0;
+    while (static_cast<int>(queries.size()) < queryCount && attempts++ < queryCount * 100) {
+        sf::Vector2i a(randX(rng), randY(rng));
+        sf::Vector2i b(randX(rng), randY(rng));
+        if (grid.isWalkable(a) && grid.isWalkable(b)) queries.push_back({a, b});
+    }
+
+    cout << "Benchmarking " << queries.size() << " random queries on a "
+         << grid.width << "x" << grid.height << " map" << endl;
+    if (queries.empty()) return;
+
+    Pathfinder pathfinder;
+    BenchmarkTable table(queries);
+    auto explored = [&] { return pathfinder.getNodesExplored(); };
+
+    SearchResult baseline;
+    auto baselineExpanded = [&] { return baseline.stats.expanded; };
+    table.row("Dijkstra (hash maps)", [&](sf::Vector2i s, sf::Vector2i g) { return (baseline = findDijkstraPath(map, s, g)).path; },
+              baselineExpanded, true);
+    pathfinder.setUnitCostEngine(false);
+    table.row("Dijkstra (workspace heap)", [&](sf::Vector2i s, sf::Vector2i g) { return pathfinder.findDijkstraPath(grid, s, g); }, explored);
+    pathfinder.setUnitCostEngine(true);
+    table.row("Dijkstra (unit-cost BFS)", [&](sf::Vector2i s, sf::Vector2i g) { return pathfinder.findDijkstraPath(grid, s, g); }, explored);
+    BitParallelBfs bitBfs;
+    table.row("Dijkstra (bit-parallel BFS)", [&](sf::Vector2i s, sf::Vector2i g) { return bitBfs.findPath(grid, s, g); },
+              [&] { return bitBfs.getNodesExplored(); });
+    table.row("A* (hash maps)", [&](sf::Vector2i s, sf::Vector2i g) { return (baseline = findAStarPath(map, s, g)).path; },
+              baselineExpanded, true);
+    pathfinder.setUnitCostEngine(false);
+    table.row("A* (workspace heap)", [&](sf::Vector2i s, sf::Vector2i g) { return pathfinder.findAStarPath(grid, s, g); }, explored);
+    HandWrittenAStar handWritten;
+    table.row("A* (hand-written heap)", [&](sf::Vector2i s, sf::Vector2i g) { return handWritten.findPath(grid, s, g); },
+              [&] { return handWritten.expanded; });
+    // Same heap, guided by landmarks; compare its expanded count with the Manhattan row above
+    auto landmarks = LandmarkTable::build(grid, 8);
+    table.row("A* (ALT, " + to_string(landmarks->count) + " landmarks)",
+              [&](sf::Vector2i s, sf::Vector2i g) { return pathfinder.findAStarPath(grid, s, g, *landmarks); }, explored);
+    pathfinder.setUnitCostEngine(true);
+    table.row("A* (unit-cost buckets)", [&](sf::Vector2i s, sf::Vector2i g) { return pathfinder.findAStarPath(grid, s, g); }, explored);
+    // Table lookups only; a mismatch is a route lava has spread over since the table was built
+    if (firstMoves && firstMoves->fits(grid)) {
+        table.row("First-move table (CPD)", [&](sf::Vector2i s, sf::Vector2i g) { return firstMoves->findPath(grid, s, g).path; },
+                  [] { return 0; });
+    }
+
+    // The search kernel with diagonal moves; paths are shorter, so lengths are expected to differ
+    BinaryHeapOpen heap;
+    SearchWorkspace workspace;
+    int kernelExpanded = 0;
+    table.row("A* (kernel, 8-connected)", [&](sf::Vector2i s, sf::Vector2i g) {
+        kernelExpanded = 0;
+        ExpansionCounter stats{kernelExpanded};
+        int from = grid.index(s);
+        int to = grid.index(g);
+        if (!runSearch<EightNeighbours>(grid, from, to, OctileHeuristic{g}, heap, workspace, stats, [] { return false; })) return vector<sf::Vector2i>();
+        return tracePath(grid, workspace, from, to);
+    }, [&] { return kernelExpanded; });
+
+    // The same A* spread over a thread pool
+    BatchPathfinder singleThread(1);
+    BatchPathfinder allThreads;
+    table.batchRow("A* batch (1 thread)", [&](const vector<BatchQuery>& q) { return singleThread.findAStarPaths(grid, q); });
+    if (allThreads.getThreadCount() > 1) {
+        table.batchRow("A* batch (" + to_string(allThreads.getThreadCount()) + " threads)",
+                       [&](const vector<BatchQuery>& q) { return allThreads.findAStarPaths(grid, q); });
+    }
+
+    table.row("Bidirectional Dijkstra", [&](sf::Vector2i s, sf::Vector2i g) { return pathfinder.findBidirectionalDijkstraPath(grid, s, g); }, explored);
+    table.row("Bidirectional A*", [&](sf::Vector2i s, sf::Vector2i g) { return pathfinder.findBidirectionalAStarPath(grid, s, g); }, explored);
+    table.row("JPS", [&](sf::Vector2i s, sf::Vector2i g) { return pathfinder.findJPSPath(grid, s, g); }, explored);
+    pathfinder.findJPSPlusPath(map, queries[0].start, queries[0].goal); // build the jump table outside the timing
+    table.row("JPS+", [&](sf::Vector2i s, sf::Vector2i g) { return pathfinder.findJPSPlusPath(map, s, g); }, explored);
+
+    ContractionHierarchy hierarchy;
+    hierarchy.sync(map); // build and customize outside the timing
+    table.row("CH (customizable)", [&](sf::Vector2i s, sf::Vector2i g) { return hierarchy.findPath(map, s, g); },
+              [&] { return hierarchy.getNodesExplored(); });
+
+    // HPA* is near-optimal, so some path lengths are expected to differ
+    HierarchicalPathfinder hpa;
+    hpa.sync(map);
+    table.row("HPA* (fully refined)", [&](sf::Vector2i s, sf::Vector2i g) {
+        HpaRoute route;
+        if (!hpa.findRoute(map, s, g, route)) return vector<sf::Vector2i>();
+        hpa.refine(route, static_cast<int>(route.waypoints.size()));
+        return route.tiles;
+    }, [&] { return hpa.getNodesExplored(); });
+
+    // Long routes, where lava has the most time to get in the way. The space-time search
+    // detours around tiles the forecast says lava could reach first, or gives up, so its
+    // mismatches are the routes plain A* would have walked into forecast lava.
+    vector<BatchQuery> longQueries;
+    attempts = 0;
+    while (static_cast<int>(longQueries.size()) < queryCount && attempts++ < queryCount * 1000) {
+        sf::Vector2i a(randX(rng), randY(rng));
+        sf::Vector2i b(randX(rng), randY(rng));
+        if (abs(a.x - b.x) + abs(a.y - b.y) >= 200 && grid.isWalkable(a) && grid.isWalkable(b)) longQueries.push_back({a, b});
+    }
+    if (!longQueries.empty()) {
+        cout << "Long routes: " << longQueries.size() << " queries at least 200 tiles apart" << endl;
+        LavaForecast forecast;
+        forecast.sync(map);
+        BenchmarkTable longTable(longQueries);
+        pathfinder.setUnitCostEngine(false);
+        longTable.row("A* (workspace heap)", [&](sf::Vector2i s, sf::Vector2i g) { return pathfinder.findAStarPath(grid, s, g); },
+                      explored, true);
+        SpaceTimeAStar spaceTime;
+        SearchResult timed;
+        longTable.row("Space-time A* (forecast)", [&](sf::Vector2i s, sf::Vector2i g) { return (timed = spaceTime.findPath(forecast, s, g)).path; },
+                      [&] { return timed.stats.expanded; });
+    }
+
+    // One planning round for a crowd, on one thread and on all of them. Starts and goals are
+    // distinct and near each other so the agents have to get out of each other's way.
+    vector<Agent> crowd;
+    vector<unsigned char> startTaken(grid.tileCount(), 0), goalTaken(grid.tileCount(), 0);
+    uniform_int_distribution<int> offset(-60, 60);
+    sf::Vector2i centre(grid.width / 2, grid.height / 2);
+    attempts = 0;
+    while (crowd.size() < 2000 && attempts++ < 200000) {
+        sf::Vector2i a(centre.x + offset(rng), centre.y + offset(rng));
+        sf::Vector2i b(centre.x + offset(rng), centre.y + offset(rng));
+        if (!grid.isWalkable(a) || !grid.isWalkable(b) || startTaken[grid.index(a)] || goalTaken[grid.index(b)]) continue;
+        startTaken[grid.index(a)] = goalTaken[grid.index(b)] = 1;
+        crowd.push_back({a, b, {}});
+    }
+    for (unsigned threads : {1u, 0u}) {
+        CooperativePlanner planner(16, threads);
+        vector<Agent> agents = crowd;
+        PlanningStats planning = planner.planRound(grid, landmarks.get(), agents);
+        cout << fixed << setprecision(2) << "Cooperative A* (" << planner.getThreadCount() << " threads): " << planning.agents
+             << " agents in " << planning.wallMs << " ms, " << planning.waves << " waves, " << planning.rejected << " rejected, "
+             << planning.serial << " serial, " << planning.waiting << " waiting, " << planning.bumped << " bumped, "
+             << planning.expanded << " expanded, " << planner.countConflicts(agents) << " conflicts" << endl;
+    }
+
+    // Distances from one tile to the whole map, as the flow field needs them
+    vector<int> distances;
+    auto begin = chrono::steady_clock::now();
+    for (const auto& q : queries) bitBfs.distancesFrom(grid, q.goal, distances);
+    double bitMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+    FlowField flowField;
+    begin = chrono::steady_clock::now();
+    for (const auto& q : queries) flowField.setGoal(map, q.goal);
+    double fieldMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+    cout << fixed << setprecision(2) << "Whole-map distances: bit-parallel BFS " << bitMs * 1000.0 / queries.size()
+         << " us, flow field " << fieldMs * 1000.0 / queries.size() << " us per source" << endl;
+}
@@ -0,0 +1,226 @@
+#include "BitParallelBfs.h"
+#include <algorithm>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+int lowestBit(uint64_t word) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+int bitCount(uint64_t word) {
+#ifdef _MSC_VER
+    return static_cast<int>(__popcnt64(word));
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+} // namespace
+
+void BitParallelBfs::pack(const SearchGrid& searchGrid) {
+    width = searchGrid.width;
+    height = searchGrid.height;
+    wordsPerRow = (width + 63) / 64;
+    stride = (wordsPerRow + 3) / 4 * 4 + 2;
+
+    size_t words = static_cast<size_t>(height + 2) * stride;
+    walk.assign(words, 0);
+    visited.assign(words, 0);
+    frontier.assign(words, 0);
+    next.assign(words, 0);
+
+    for (int y = 0; y < height; ++y) {
+        uint64_t* row = &walk[static_cast<size_t>(y + 1) * stride + 1];
+        for (int x = 0; x < width; ++x) {
+            if (searchGrid.walkable[y * width + x]) row[x >> 6] |= uint64_t(1) << (x & 63);
+        }
+    }
+    packedVersion = searchGrid.version;
+}
+
+// Clears the search state and makes the source tile layer 0
+void BitParallelBfs::begin(int sourceIndex) {
+    fill(visited.begin(), visited.end(), 0);
+    fill(frontier.begin(), frontier.end(), 0);
+    fill(next.begin(), next.end(), 0);
+    layerStart.clear();
+    layerWords.clear();
+
+    int x = sourceIndex % width;
+    int y = sourceIndex / width;
+    size_t word = static_cast<size_t>(y + 1) * stride + 1 + (x >> 6);
+    uint64_t bit = uint64_t(1) << (x & 63);
+    frontier[word] = bit;
+    visited[word] = bit;
+    frontierRows.assign(1, y + 1);
+    nodesExplored = 1;
+    if (keepLayers) {
+        layerStart.push_back(0);
+        layerWords.push_back({word, bit});
+    }
+}
+
+// Expands the frontier by one step and makes the result the new frontier. Only rows
+// next to a frontier row can change, which on a winding map is a small share of them.
+// Returns false once nothing new is reached.
+bool BitParallelBfs::grow() {
+    if (keepLayers) layerStart.push_back(layerWords.size());
+    nextRows.clear();
+
+    int done = 0; // rows below this one were already expanded this step
+    for (int row : frontierRows) {
+        for (int r = max({row - 1, done, 1}); r <= min(row + 1, height); ++r) {
+            done = r + 1;
+            const uint64_t* f = &frontier[static_cast<size_t>(r) * stride];
+            const uint64_t* up = f - stride;
+            const uint64_t* down = f + stride;
+            const uint64_t* w = &walk[static_cast<size_t>(r) * stride];
+            uint64_t* v = &visited[static_cast<size_t>(r) * stride];
+            uint64_t* n = &next[static_cast<size_t>(r) * stride];
+
+            uint64_t any = 0;
+            int i = 1;
+#ifdef __AVX2__
+            // Unaligned loads one word back and one word ahead carry the bits across words.
+            // Rows are padded to whole vectors; the padding is never walkable, so it stays zero.
+            for (; i + 3 <= stride - 2; i += 4) {
+                __m256i here = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(f + i));
+                __m256i before = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(f + i - 1));
+                __m256i after = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(f + i + 1));
+                __m256i reach = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_slli_epi64(here, 1), _mm256_srli_epi64(before, 63)),
+                    _mm256_or_si256(_mm256_srli_epi64(here, 1), _mm256_slli_epi64(after, 63)));
+                reach = _mm256_or_si256(reach, _mm256_or_si256(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(up + i)),
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(down + i))));
+                reach = _mm256_and_si256(reach, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i)));
+                __m256i seen = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + i));
+                reach = _mm256_andnot_si256(seen, reach);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(n + i), reach);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(v + i), _mm256_or_si256(seen, reach));
+                if (!_mm256_testz_si256(reach, reach)) {
+                    for (int k = 0; k < 4; ++k) {
+                        if (!n[i + k]) continue;
+                        nodesExplored += bitCount(n[i + k]);
+                        if (keepLayers) layerWords.push_back({static_cast<size_t>(r) * stride + i + k, n[i + k]});
+                    }
+                    any = 1;
+                }
+            }
+#endif
+            for (; i <= wordsPerRow; ++i) {
+                uint64_t reach = (f[i] << 1) | (f[i - 1] >> 63) | (f[i] >> 1) | (f[i + 1] << 63) | up[i] | down[i];
+                reach &= w[i] & ~v[i];
+                n[i] = reach;
+                v[i] |= reach;
+                if (reach) {
+                    nodesExplored += bitCount(reach);
+                    if (keepLayers) layerWords.push_back({static_cast<size_t>(r) * stride + i, reach});
+                    any = 1;
+                }
+            }
+            if (any) nextRows.push_back(r);
+        }
+    }
+
+    // The old frontier becomes the scratch buffer for the next step
+    for (int r : frontierRows) {
+        fill_n(&frontier[static_cast<size_t>(r) * stride], stride, 0);
+    }
+    frontier.swap(next);
+    frontierRows.swap(nextRows);
+    return !frontierRows.empty();
+}
+
+bool BitParallelBfs::inLayer(int layer, int x, int y) const {
+    if (x < 0 || x >= width || y < 0 || y >= height) return false;
+    size_t word = static_cast<size_t>(y + 1) * stride + 1 + (x >> 6);
+    size_t end = layer + 1 < static_cast<int>(layerStart.size()) ? layerStart[layer + 1] : layerWords.size();
+    auto found = lower_bound(layerWords.begin() + layerStart[layer], layerWords.begin() + end, make_pair(word, uint64_t(0)));
+    return found != layerWords.begin() + end && found->first == word && ((found->second >> (x & 63)) & 1);
+}
+
+vector<sf::Vector2i> BitParallelBfs::findPath(const Map& map, sf::Vector2i start, sf::Vector2i goal) {
+    unsigned previousVersion = grid.version;
+    GridChange change = grid.syncFrom(map);
+    if (change == GridChange::Patched && packedVersion == previousVersion) {
+        for (int tile : grid.changedTiles) {
+            int x = tile % width;
+            int y = tile / width;
+            walk[static_cast<size_t>(y + 1) * stride + 1 + (x >> 6)] &= ~(uint64_t(1) << (x & 63));
+        }
+        packedVersion = grid.version;
+    }
+    return findPath(grid, start, goal);
+}
+
+vector<sf::Vector2i> BitParallelBfs::findPath(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal) {
+    nodesExplored = 0;
+    if (packedVersion != searchGrid.version || width != searchGrid.width || height != searchGrid.height) pack(searchGrid);
+    if (!searchGrid.isWalkable(start) || !searchGrid.isWalkable(goal)) return {};
+    if (start == goal) return {start};
+
+    keepLayers = true;
+    begin(searchGrid.index(start));
+
+    const size_t goalWord = static_cast<size_t>(goal.y + 1) * stride + 1 + (goal.x >> 6);
+    const uint64_t goalBit = uint64_t(1) << (goal.x & 63);
+    while (grow()) {
+        if (frontier[goalWord] & goalBit) break;
+    }
+    if (!(visited[goalWord] & goalBit)) return {};
+
+    // The goal sits in the last layer; any neighbour in the layer before is one step closer
+    const int dx[4] = {1, -1, 0, 0};
+    const int dy[4] = {0, 0, 1, -1};
+    vector<sf::Vector2i> path(layerStart.size());
+    sf::Vector2i current = goal;
+    path.back() = goal;
+    for (int layer = static_cast<int>(layerStart.size()) - 2; layer >= 0; --layer) {
+        for (int d = 0; d < 4; ++d) {
+            if (inLayer(layer, current.x + dx[d], current.y + dy[d])) {
+                current = {current.x + dx[d], current.y + dy[d]};
+                break;
+            }
+        }
+        path[layer] = current;
+    }
+    return path;
+}
+
+void BitParallelBfs::distancesFrom(const SearchGrid& searchGrid, sf::Vector2i source, vector<int>& distances) {
+    nodesExplored = 0;
+    if (packedVersion != searchGrid.version || width != searchGrid.width || height != searchGrid.height) pack(searchGrid);
+    distances.assign(searchGrid.tileCount(), -1);
+    if (!searchGrid.isWalkable(source)) return;
+
+    // No path is needed, so the layers are read off as they are made instead of kept
+    keepLayers = false;
+    begin(searchGrid.index(source));
+    distances[searchGrid.index(source)] = 0;
+    for (int distance = 1; grow(); ++distance) {
+        for (int r : frontierRows) {
+            const uint64_t* row = &frontier[static_cast<size_t>(r) * stride + 1];
+            for (int i = 0; i < wordsPerRow; ++i) {
+                for (uint64_t bits = row[i]; bits; bits &= bits - 1) {
+                    distances[(r - 1) * width + i * 64 + lowestBit(bits)] = distance;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#include "Comparison.h"
+#include "Pathfinder.h"
+#include <chrono>
+
+using namespace std;
+
+bool Comparison::start(shared_ptr<const SearchGrid> snapshot, sf::Vector2i from, sf::Vector2i to) {
+    if (isRunning()) return false;
+    discarded = false;
+    searchedFrom = from;
+    searchedTo = to;
+    searchedLayout = snapshot->layout;
+
+    auto run = [snapshot, from, to](auto search) {
+        return async(launch::async, [snapshot, from, to, search] {
+            Pathfinder pathfinder;
+            SearchResult outcome;
+            outcome.path = (pathfinder.*search)(*snapshot, from, to);
+            outcome.stats = pathfinder.getLastStats();
+            return outcome;
+        });
+    };
+
+    using Search = vector<sf::Vector2i> (Pathfinder::*)(const SearchGrid&, sf::Vector2i, sf::Vector2i);
+    dijkstra = run(static_cast<Search>(&Pathfinder::findDijkstraPath));
+    astar = run(static_cast<Search>(&Pathfinder::findAStarPath));
+    return true;
+}
+
+bool Comparison::poll(ComparisonResult& result) {
+    if (!isRunning()) return false;
+
+    auto ready = [](const future<SearchResult>& f) { return f.wait_for(chrono::seconds(0)) == future_status::ready; };
+    if (!ready(dijkstra) || !ready(astar)) return false;
+
+    SearchResult d = dijkstra.get();
+    SearchResult a = astar.get();
+    if (discarded) {
+        discarded = false;
+        return false;
+    }
+
+    result.start = searchedFrom;
+    result.goal = searchedTo;
+    result.layout = searchedLayout;
+    result.dijkstraPath = move(d.path);
+    result.astarPath = move(a.path);
+    result.dijkstraStats = d.stats;
+    result.astarStats = a.stats;
+    return true;
+}
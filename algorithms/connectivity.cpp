@@ -0,0 +1,154 @@
+#include "Connectivity.h"
+
+using namespace std;
+
+namespace {
+const int dx[4] = {1, -1, 0, 0};
+const int dy[4] = {0, 0, 1, -1};
+}
+
+void Connectivity::sync(const Map& map) {
+    if (grid.version == map.getVersion()) return;
+
+    unsigned previousLayout = grid.layout;
+    vector<unsigned char> previousWalkable = grid.walkable;
+    GridChange change = grid.syncFrom(map);
+    tilesRelabelled = 0;
+
+    if (change == GridChange::Patched) {
+        for (int tile : grid.changedTiles) close(tile);
+    } else if (change == GridChange::Rebuilt) {
+        if (grid.layout != previousLayout || previousWalkable.size() != grid.walkable.size()) {
+            build();
+            return;
+        }
+        // Missed ticks on the same layout: only closures can have happened
+        for (int i = 0; i < grid.tileCount(); ++i) {
+            if (previousWalkable[i] && !grid.walkable[i]) close(i);
+        }
+    }
+}
+
+// Plain BFS flood; returns the number of tiles labelled
+int Connectivity::flood(int seed, int newLabel) {
+    vector<int>& queue = queues[0];
+    queue.clear();
+    queue.push_back(seed);
+    label[seed] = newLabel;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int current = queue[head];
+        int x = current % grid.width;
+        int y = current / grid.width;
+        for (int d = 0; d < 4; ++d) {
+            int nx = x + dx[d];
+            int ny = y + dy[d];
+            if (!grid.isWalkable(nx, ny)) continue;
+            int next = ny * grid.width + nx;
+            if (label[next] == newLabel) continue;
+            label[next] = newLabel;
+            queue.push_back(next);
+        }
+    }
+    return static_cast<int>(queue.size());
+}
+
+void Connectivity::build() {
+    label.assign(grid.tileCount(), -1);
+    nextLabel = 0;
+    for (int i = 0; i < grid.tileCount(); ++i) {
+        if (grid.walkable[i] && label[i] < 0) tilesRelabelled += flood(i, nextLabel++);
+    }
+}
+
+void Connectivity::close(int tile) {
+    int component = label[tile];
+    label[tile] = -1;
+    if (component < 0) return;
+
+    // The closed tile's open neighbours; with fewer than two there is nothing to split
+    int seeds[4];
+    int count = 0;
+    int x = tile % grid.width;
+    int y = tile / grid.width;
+    for (int d = 0; d < 4; ++d) {
+        int nx = x + dx[d];
+        int ny = y + dy[d];
+        if (grid.isWalkable(nx, ny) && label[ny * grid.width + nx] == component) seeds[count++] = ny * grid.width + nx;
+    }
+    if (count < 2) return;
+
+    // Race one BFS per neighbour, a tile at a time each. Searches that touch join a group
+    // (tiny union-find); a group whose queues all run dry is a region the tile cut off.
+    int group[4];
+    bool done[4] = {false, false, false, false};
+    auto find = [&](int s) { while (group[s] != s) s = group[s]; return s; };
+
+    owner.reset(grid.tileCount());
+    for (int s = 0; s < count; ++s) {
+        group[s] = s;
+        queues[s].clear();
+        heads[s] = 0;
+        if (owner.visited(seeds[s])) {
+            group[s] = find(owner.costOf(seeds[s]));
+            done[s] = true; // another seed already owns this tile
+            continue;
+        }
+        owner.set(seeds[s], s, s);
+        queues[s].push_back(seeds[s]);
+    }
+
+    while (true) {
+        // Groups still in the race, and whether any of them has run dry
+        int live = 0;
+        for (int s = 0; s < count; ++s) {
+            if (!done[s] && find(s) == s) live++;
+        }
+        if (live <= 1) break;
+
+        for (int s = 0; s < count; ++s) {
+            if (done[s] || find(s) != s) continue;
+
+            // A group is dry once every member's queue is empty
+            bool dry = true;
+            for (int m = 0; m < count; ++m) {
+                if (find(m) == s && heads[m] < queues[m].size()) dry = false;
+            }
+            if (dry) {
+                int newLabel = nextLabel++;
+                for (int m = 0; m < count; ++m) {
+                    if (find(m) != s) continue;
+                    for (int t : queues[m]) label[t] = newLabel;
+                    tilesRelabelled += static_cast<int>(queues[m].size());
+                }
+                done[s] = true;
+                continue;
+            }
+
+            // Expand one tile from each member with work left
+            for (int m = 0; m < count; ++m) {
+                if (find(m) != s || heads[m] >= queues[m].size()) continue;
+                int current = queues[m][heads[m]++];
+                int cx = current % grid.width;
+                int cy = current / grid.width;
+                for (int d = 0; d < 4; ++d) {
+                    int nx = cx + dx[d];
+                    int ny = cy + dy[d];
+                    if (!grid.isWalkable(nx, ny)) continue;
+                    int next = ny * grid.width + nx;
+                    if (owner.visited(next)) {
+                        int other = find(owner.costOf(next));
+                        if (other != find(m)) group[other] = find(m); // the regions are still connected
+                        continue;
+                    }
+                    owner.set(next, m, current);
+                    queues[m].push_back(next);
+                }
+            }
+        }
+    }
+}
+
+bool Connectivity::connected(sf::Vector2i a, sf::Vector2i b) const {
+    if (!grid.isWalkable(a) || !grid.isWalkable(b)) return false;
+    return label[grid.index(a)] == label[grid.index(b)];
+}
@@ -0,0 +1,392 @@
+#include "ContractionHierarchy.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+
+using namespace std;
+
+namespace {
+
+// Nested dissection: order both halves of the rectangle first, then the row or column
+// separating them. Separators end up above everything they separate, which keeps the
+// shortcuts created by contracting a half inside that half.
+void dissect(int left, int top, int right, int bottom, int width, vector<int>& order) {
+    int w = right - left;
+    int h = bottom - top;
+    if (w <= 0 || h <= 0) return;
+    if (w * h <= 16) {
+        for (int y = top; y < bottom; ++y)
+            for (int x = left; x < right; ++x) order.push_back(y * width + x);
+        return;
+    }
+    if (w >= h) {
+        int mid = left + w / 2;
+        dissect(left, top, mid, bottom, width, order);
+        dissect(mid + 1, top, right, bottom, width, order);
+        for (int y = top; y < bottom; ++y) order.push_back(y * width + mid);
+    } else {
+        int mid = top + h / 2;
+        dissect(left, top, right, mid, width, order);
+        dissect(left, mid + 1, right, bottom, width, order);
+        for (int x = left; x < right; ++x) order.push_back(mid * width + x);
+    }
+}
+
+} // namespace
+
+void ContractionHierarchy::buildTopology(int width, int height) {
+    builtWidth = width;
+    builtHeight = height;
+    const int n = width * height;
+
+    tileOf.clear();
+    tileOf.reserve(n);
+    dissect(0, 0, width, height, width, tileOf);
+    rankOf.assign(n, 0);
+    for (int r = 0; r < n; ++r) rankOf[tileOf[r]] = r;
+
+    // Symbolic elimination: contracting a node links all its higher neighbours, which is
+    // the same as handing them to the lowest of them (its parent in the elimination tree)
+    vector<vector<int>> up(n);
+    const int dx[4] = {1, -1, 0, 0};
+    const int dy[4] = {0, 0, 1, -1};
+    for (int tile = 0; tile < n; ++tile) {
+        int x = tile % width;
+        int y = tile / width;
+        for (int d = 0; d < 4; ++d) {
+            int nx = x + dx[d];
+            int ny = y + dy[d];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+            int a = rankOf[tile];
+            int b = rankOf[ny * width + nx];
+            if (a < b) up[a].push_back(b);
+        }
+    }
+    for (int r = 0; r < n; ++r) {
+        auto& heads = up[r];
+        sort(heads.begin(), heads.end());
+        heads.erase(unique(heads.begin(), heads.end()), heads.end());
+        if (heads.size() > 1) {
+            auto& parent = up[heads[0]];
+            parent.insert(parent.end(), heads.begin() + 1, heads.end());
+        }
+    }
+
+    firstUp.assign(n + 1, 0);
+    for (int r = 0; r < n; ++r) firstUp[r + 1] = firstUp[r] + static_cast<int>(up[r].size());
+    upHead.clear();
+    upHead.reserve(firstUp[n]);
+    for (int r = 0; r < n; ++r) {
+        upHead.insert(upHead.end(), up[r].begin(), up[r].end());
+        vector<int>().swap(up[r]);
+    }
+
+    firstDown.assign(n + 1, 0);
+    for (int head : upHead) firstDown[head + 1]++;
+    for (int r = 0; r < n; ++r) firstDown[r + 1] += firstDown[r];
+    downArc.assign(upHead.size(), 0);
+    downTail.assign(upHead.size(), 0);
+    vector<int> fill(firstDown.begin(), firstDown.end() - 1);
+    for (int r = 0; r < n; ++r) {
+        for (int arc = firstUp[r]; arc < firstUp[r + 1]; ++arc) {
+            int slot = fill[upHead[arc]]++;
+            downArc[slot] = arc;
+            downTail[slot] = r;
+        }
+    }
+
+    weight.assign(upHead.size(), INF);
+    middle.assign(upHead.size(), -1);
+    arcDirty.assign(upHead.size(), 0);
+}
+
+int ContractionHierarchy::findArc(int low, int high) const {
+    auto begin = upHead.begin() + firstUp[low];
+    auto end = upHead.begin() + firstUp[low + 1];
+    auto it = lower_bound(begin, end, high);
+    return it != end && *it == high ? static_cast<int>(it - upHead.begin()) : -1;
+}
+
+// Weight of the arc as a plain grid edge: 1 between two open neighbours, otherwise closed
+int ContractionHierarchy::edgeWeight(int low, int high) const {
+    int a = tileOf[low];
+    int b = tileOf[high];
+    int width = grid.width;
+    if (abs(a % width - b % width) + abs(a / width - b / width) != 1) return INF;
+    return grid.walkable[a] && grid.walkable[b] ? 1 : INF;
+}
+
+// Full customization: every lower triangle (v; u, w) offers the path u - v - w for arc
+// (u, w). Nodes are processed bottom-up, so an arc's weight is final before any
+// triangle above it uses it. The higher neighbours of v above u are all neighbours of
+// u too, so each arc (u, w) is found by walking u's sorted arc list alongside v's.
+void ContractionHierarchy::customize() {
+    const int n = static_cast<int>(tileOf.size());
+    for (int low = 0; low < n; ++low) {
+        for (int arc = firstUp[low]; arc < firstUp[low + 1]; ++arc) {
+            weight[arc] = edgeWeight(low, upHead[arc]);
+            middle[arc] = -1;
+        }
+    }
+
+    for (int v = 0; v < n; ++v) {
+        for (int i = firstUp[v]; i < firstUp[v + 1]; ++i) {
+            if (weight[i] >= INF) continue;
+            int u = upHead[i];
+            int scan = firstUp[u];
+            for (int j = i + 1; j < firstUp[v + 1]; ++j) {
+                if (weight[j] >= INF) continue;
+                int w = upHead[j];
+                while (upHead[scan] < w) ++scan;
+                int through = weight[i] + weight[j];
+                if (through < weight[scan]) {
+                    weight[scan] = through;
+                    middle[scan] = tileOf[v];
+                }
+            }
+        }
+    }
+    arcsUpdated = static_cast<int>(upHead.size());
+}
+
+void ContractionHierarchy::markDirty(int a, int b) {
+    int low = min(a, b);
+    int arc = findArc(low, max(a, b));
+    if (arc < 0 || arcDirty[arc]) return;
+    arcDirty[arc] = 1;
+    dirtyArcs.push_back({low, arc});
+    push_heap(dirtyArcs.begin(), dirtyArcs.end(), greater<pair<int, int>>());
+}
+
+// Partial customization after tiles closed. Weights only grow, so an arc needs
+// recomputing only if it was closed directly or one of its lower triangles used to give
+// its weight. Each such arc is recomputed from its own edge and every lower triangle
+// (v; u, w), found by intersecting the incoming lists of u and w. A changed arc (u, w)
+// is a side of the triangles (u; w, x) above it, and those arcs are queued if the old
+// weight supported them. The queue is ordered by lower endpoint, so every arc is
+// final before any arc above it reads it.
+void ContractionHierarchy::customize(const vector<int>& closedTiles) {
+    const greater<pair<int, int>> minHeap;
+    const int width = grid.width;
+    const int dx[4] = {1, -1, 0, 0};
+    const int dy[4] = {0, 0, 1, -1};
+    arcsUpdated = 0;
+    dirtyArcs.clear();
+
+    for (int tile : closedTiles) {
+        int x = tile % width;
+        int y = tile / width;
+        for (int d = 0; d < 4; ++d) {
+            int nx = x + dx[d];
+            int ny = y + dy[d];
+            if (grid.inBounds(nx, ny)) markDirty(rankOf[tile], rankOf[ny * width + nx]);
+        }
+    }
+
+    while (!dirtyArcs.empty()) {
+        pop_heap(dirtyArcs.begin(), dirtyArcs.end(), minHeap);
+        auto [u, arc] = dirtyArcs.back();
+        dirtyArcs.pop_back();
+        arcDirty[arc] = 0;
+
+        int w = upHead[arc];
+        int best = edgeWeight(u, w);
+        int bestMiddle = -1;
+        int i = firstDown[u], iEnd = firstDown[u + 1];
+        int j = firstDown[w], jEnd = firstDown[w + 1];
+        while (i < iEnd && j < jEnd) {
+            if (downTail[i] < downTail[j]) ++i;
+            else if (downTail[j] < downTail[i]) ++j;
+            else {
+                int through = weight[downArc[i]] + weight[downArc[j]];
+                if (through < best) {
+                    best = through;
+                    bestMiddle = tileOf[downTail[i]];
+                }
+                ++i;
+                ++j;
+            }
+        }
+        best = min(best, INF);
+
+        int previous = weight[arc];
+        middle[arc] = bestMiddle;
+        if (best == previous) continue;
+        weight[arc] = best;
+        arcsUpdated++;
+
+        if (previous >= INF) continue;
+        for (int k = firstUp[u]; k < firstUp[u + 1]; ++k) {
+            int x = upHead[k];
+            if (x == w || weight[k] >= INF) continue;
+            int side = findArc(min(w, x), max(w, x));
+            if (previous + weight[k] == weight[side]) markDirty(w, x);
+        }
+    }
+}
+
+void ContractionHierarchy::rebuild(const SearchGrid& snapshot) {
+    grid = snapshot;
+    if (grid.width != builtWidth || grid.height != builtHeight) buildTopology(grid.width, grid.height);
+    customize();
+}
+
+void ContractionHierarchy::sync(const Map& map) {
+    if (builtWidth > 0 && grid.version == map.getVersion()) return;
+
+    unsigned previousLayout = grid.layout;
+    previousWalkable = grid.walkable;
+    GridChange change = grid.syncFrom(map);
+
+    if (grid.width != builtWidth || grid.height != builtHeight) {
+        buildTopology(grid.width, grid.height);
+        customize();
+    } else if (change == GridChange::Patched) {
+        customize(grid.changedTiles);
+    } else if (change == GridChange::Rebuilt && grid.layout != previousLayout) {
+        customize();
+    } else if (change == GridChange::Rebuilt) {
+        // Several spread ticks since the last query: the same layout can only have closed tiles
+        closedTiles.clear();
+        for (int i = 0; i < grid.tileCount(); ++i) {
+            if (previousWalkable[i] && !grid.walkable[i]) closedTiles.push_back(i);
+        }
+        customize(closedTiles);
+    }
+}
+
+// Appends the tiles after from, up to and including to, that the arc between them stands for
+void ContractionHierarchy::unpack(int from, int to, vector<sf::Vector2i>& out) const {
+    vector<pair<int, int>> stack = {{from, to}};
+    while (!stack.empty()) {
+        auto [a, b] = stack.back();
+        stack.pop_back();
+        int arc = findArc(min(a, b), max(a, b));
+        if (middle[arc] < 0) {
+            out.push_back(grid.tile(tileOf[b]));
+            continue;
+        }
+        int m = rankOf[middle[arc]];
+        stack.push_back({m, b});
+        stack.push_back({a, m});
+    }
+}
+
+void ContractionHierarchy::relax(SearchWorkspace& side, int rank) {
+    int cost = side.costOf(rank);
+    if (cost >= INF) return;
+    nodesExplored++;
+    for (int arc = firstUp[rank]; arc < firstUp[rank + 1]; ++arc) {
+        if (weight[arc] >= INF) continue;
+        int next = upHead[arc];
+        int newCost = cost + weight[arc];
+        if (newCost < side.costOf(next)) side.set(next, newCost, rank);
+    }
+}
+
+// Elimination tree query: every tile an upward search from s can reach is an ancestor of
+// s in the elimination tree, so instead of a priority queue both searches just relax
+// their ancestors bottom-up. Below the lowest common ancestor the two paths are disjoint;
+// from there on both run together and every shared tile is a candidate meeting point.
+vector<sf::Vector2i> ContractionHierarchy::findPath(const Map& map, sf::Vector2i start, sf::Vector2i goal) {
+    sync(map);
+    nodesExplored = 0;
+    if (!grid.isWalkable(start) || !grid.isWalkable(goal)) return {};
+
+    const int n = grid.tileCount();
+    const int source = rankOf[grid.index(start)];
+    const int target = rankOf[grid.index(goal)];
+
+    forward.reset(n);
+    backward.reset(n);
+    forward.set(source, 0, source);
+    backward.set(target, 0, target);
+
+    int s = source;
+    int t = target;
+    while (s != t && s >= 0 && t >= 0) {
+        if (s < t) {
+            relax(forward, s);
+            s = parentOf(s);
+        } else {
+            relax(backward, t);
+            t = parentOf(t);
+        }
+    }
+    if (s != t) return {}; // different trees: nothing connects the two tiles
+
+    int best = INF;
+    int meet = -1;
+    for (int v = s; v >= 0; v = parentOf(v)) {
+        relax(forward, v);
+        relax(backward, v);
+        int through = forward.visited(v) && backward.visited(v) ? forward.costOf(v) + backward.costOf(v) : INF;
+        if (through < best) {
+            best = through;
+            meet = v;
+        }
+    }
+
+    if (meet < 0) return {};
+
+    // Climb from the start to the meeting node, then down to the goal, unpacking each arc
+    vector<int> ranks;
+    for (int r = meet; r != source; r = forward.parentOf(r)) ranks.push_back(r);
+    ranks.push_back(source);
+    reverse(ranks.begin(), ranks.end());
+    for (int r = meet; r != target; ) {
+        r = backward.parentOf(r);
+        ranks.push_back(r);
+    }
+
+    vector<sf::Vector2i> path = {start};
+    path.reserve(best + 1);
+    for (size_t i = 0; i + 1 < ranks.size(); ++i) unpack(ranks[i], ranks[i + 1], path);
+    return path;
+}
+
+void Contractions::startBuild(unique_ptr<ContractionHierarchy> previous) {
+    auto snapshot = make_shared<const SearchGrid>(grid);
+    building = async(launch::async, [snapshot, previous = move(previous)]() mutable {
+        if (!previous) previous = make_unique<ContractionHierarchy>();
+        previous->rebuild(*snapshot);
+        return move(previous);
+    });
+}
+
+void Contractions::sync(const Map& map) {
+    unsigned previousLayout = grid.layout;
+    grid.syncFrom(map);
+
+    // Once there is a hierarchy, every regeneration re-customizes it in the background
+    if (grid.layout != previousLayout) {
+        if (isBuilding()) rebuildAgain = true;
+        else if (hierarchy) startBuild(move(hierarchy));
+    }
+
+    if (isBuilding() && building.wait_for(chrono::seconds(0)) == future_status::ready) {
+        auto built = building.get();
+        if (rebuildAgain) {
+            rebuildAgain = false;
+            startBuild(move(built));
+        } else {
+            hierarchy = move(built);
+            justFinished = waiting;
+            waiting = false;
+        }
+    }
+}
+
+bool Contractions::request() {
+    if (hierarchy) return true;
+    if (!isBuilding()) startBuild(nullptr);
+    waiting = true;
+    return false;
+}
+
+bool Contractions::takeFinished() {
+    bool finished = justFinished;
+    justFinished = false;
+    return finished;
+}
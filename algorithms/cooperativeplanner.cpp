@@ -0,0 +1,281 @@
+#include "CooperativePlanner.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+using namespace std;
+
+size_t CooperativePlanner::StateTable::slotOf(int key) const {
+    // Fibonacci hashing spreads the step * tileCount + tile keys over the table
+    size_t mask = keys.size() - 1;
+    size_t slot = (static_cast<uint32_t>(key) * 2654435769u) & mask;
+    while (stamps[slot] == generation && keys[slot] != key) slot = (slot + 1) & mask;
+    return slot;
+}
+
+void CooperativePlanner::StateTable::grow() {
+    vector<int> oldKeys = move(keys), oldCosts = move(costs), oldParents = move(parents);
+    vector<unsigned> oldStamps = move(stamps);
+    size_t capacity = max<size_t>(1024, oldKeys.size() * 2);
+    keys.assign(capacity, 0);
+    costs.assign(capacity, 0);
+    parents.assign(capacity, 0);
+    stamps.assign(capacity, 0);
+    for (size_t i = 0; i < oldKeys.size(); ++i) {
+        if (oldStamps[i] != generation) continue;
+        size_t slot = slotOf(oldKeys[i]);
+        keys[slot] = oldKeys[i];
+        costs[slot] = oldCosts[i];
+        parents[slot] = oldParents[i];
+        stamps[slot] = generation;
+    }
+}
+
+void CooperativePlanner::StateTable::reset() {
+    if (keys.empty()) grow();
+    if (++generation == 0) {
+        fill(stamps.begin(), stamps.end(), 0);
+        generation = 1;
+    }
+    used = 0;
+}
+
+int CooperativePlanner::StateTable::find(int key) const {
+    size_t slot = slotOf(key);
+    return stamps[slot] == generation ? static_cast<int>(slot) : -1;
+}
+
+int CooperativePlanner::StateTable::insert(int key, int cost, int parent) {
+    if ((used + 1) * 2 > keys.size()) grow();
+    size_t slot = slotOf(key);
+    keys[slot] = key;
+    costs[slot] = cost;
+    parents[slot] = parent;
+    stamps[slot] = generation;
+    used++;
+    return static_cast<int>(slot);
+}
+
+CooperativePlanner::CooperativePlanner(int windowSteps, unsigned threadCount, int maxExpansionsPerAgent)
+    : pool(threadCount), workers(pool.size()), window(max(2, windowSteps)), maxExpansions(maxExpansionsPerAgent) {}
+
+void CooperativePlanner::reset() {
+    reservations.reset(0, window);
+    roundStart = 0;
+    planned = 0;
+}
+
+// Space-time A* over the next `window` steps. Ends at the goal once the agent can stay
+// there for the rest of the window, or at the last step of the window with the lowest
+// steps-so-far + estimate. Reads the reservations only, so workers can run it at once.
+bool CooperativePlanner::searchWindow(Worker& worker, const SearchGrid& grid, const LandmarkTable* landmarks,
+                                      int agent, const Agent& a, vector<sf::Vector2i>& plan) const {
+    const int tileCount = grid.tileCount();
+    const int startTile = grid.index(a.position);
+    const int goalTile = grid.index(a.goal);
+    const uint16_t* goalRow = landmarks ? landmarks->at(goalTile) : nullptr;
+    auto estimate = [&](int tile) {
+        int h = abs(tile % grid.width - a.goal.x) + abs(tile / grid.width - a.goal.y);
+        return goalRow ? max(h, landmarks->estimate(tile, goalRow)) : h;
+    };
+    auto canRestAtGoal = [&](int step) {
+        for (int k = step; k < window; ++k) {
+            if (!reservations.isFreeFor(goalTile, roundStart + k, agent)) return false;
+        }
+        return true;
+    };
+
+    const int dx[5] = {0, 1, -1, 0, 0}; // waiting in place first
+    const int dy[5] = {0, 0, 0, 1, -1};
+    StateTable& states = worker.states;
+    BinaryHeapOpen& open = worker.open;
+    states.reset();
+    open.clear();
+    worker.expanded = 0;
+    states.insert(startTile, 0, -1);
+    open.push(estimate(startTile), startTile);
+
+    int last = -1;
+    while (!open.empty() && worker.expanded < maxExpansions) {
+        auto [priority, key] = open.pop();
+        int step = key / tileCount;
+        int tile = key % tileCount;
+        int slot = states.find(key);
+        int cost = states.costAt(slot);
+        if (priority - estimate(tile) > cost) continue;
+        worker.expanded++;
+
+        if (step == window - 1 || (tile == goalTile && canRestAtGoal(step))) {
+            last = key;
+            break;
+        }
+
+        int x = tile % grid.width;
+        int y = tile / grid.width;
+        int nextStep = roundStart + step + 1;
+        for (int d = 0; d < 5; ++d) {
+            if (!grid.isWalkable(x + dx[d], y + dy[d])) continue;
+            int next = grid.index(x + dx[d], y + dy[d]);
+            if (!reservations.isFreeFor(next, nextStep, agent)) continue;
+            // Two agents may not swap tiles in one step
+            if (d > 0) {
+                int other = reservations.holderOf(next, nextStep - 1);
+                if (other >= 0 && other != agent && reservations.holderOf(tile, nextStep) == other) continue;
+            }
+            int nextKey = (step + 1) * tileCount + next;
+            int nextCost = cost + 1;
+            int found = states.find(nextKey);
+            if (found >= 0) {
+                if (nextCost >= states.costAt(found)) continue;
+                states.update(found, nextCost, key);
+            } else {
+                states.insert(nextKey, nextCost, key);
+            }
+            open.push(nextCost + estimate(next), nextKey);
+        }
+    }
+    if (last < 0) return false;
+
+    plan.assign(window, a.goal);
+    for (int key = last; key >= 0; key = states.parentAt(states.find(key))) {
+        plan[key / tileCount] = grid.tile(key % tileCount);
+    }
+    return true;
+}
+
+bool CooperativePlanner::clashes(int agent, const vector<sf::Vector2i>& plan, const SearchGrid& grid) const {
+    for (int k = 1; k < window; ++k) {
+        int tile = grid.index(plan[k]);
+        int step = roundStart + k;
+        if (!reservations.isFreeFor(tile, step, agent)) return true;
+        int previous = grid.index(plan[k - 1]);
+        int other = reservations.holderOf(tile, step - 1);
+        if (tile != previous && other >= 0 && other != agent && reservations.holderOf(previous, step) == other) return true;
+    }
+    return false;
+}
+
+void CooperativePlanner::commit(int agent, const vector<sf::Vector2i>& plan, const SearchGrid& grid) {
+    for (int k = 0; k < window; ++k) reservations.reserve(grid.index(plan[k]), roundStart + k, agent);
+}
+
+PlanningStats CooperativePlanner::planRound(const SearchGrid& grid, const LandmarkTable* landmarks, vector<Agent>& agents) {
+    auto began = chrono::steady_clock::now();
+    PlanningStats stats;
+    stats.agents = static_cast<int>(agents.size());
+    if (landmarks && !landmarks->matches(grid)) landmarks = nullptr;
+
+    // This round's plans replace what is left of the last round's
+    if (planned != static_cast<int>(agents.size()) || reservations.getTileCount() != grid.tileCount()) {
+        reservations.reset(grid.tileCount(), window);
+        roundStart = 0;
+    } else {
+        for (const Agent& a : agents) {
+            for (size_t k = 0; k < a.plan.size(); ++k) reservations.release(grid.index(a.plan[k]), roundStart + static_cast<int>(k));
+        }
+        reservations.advanceTo(roundStart);
+    }
+    // Where everyone stands now is taken before anybody plans
+    for (size_t i = 0; i < agents.size(); ++i) {
+        reservations.reserve(grid.index(agents[i].position), roundStart, static_cast<int>(i));
+    }
+
+    vector<int> pending(agents.size());
+    for (size_t i = 0; i < agents.size(); ++i) pending[i] = static_cast<int>(i);
+    vector<vector<sf::Vector2i>> candidates(agents.size());
+    vector<unsigned char> found(agents.size(), 0);
+    vector<int> expanded(agents.size(), 0);
+
+    // Waves run while enough agents are left to be worth a pass. The cutoff is fixed rather
+    // than tied to the thread count, so the same agents end up in the same waves on any machine.
+    const int maxWaves = 4;
+    const size_t minWaveSize = 64;
+    while (!pending.empty() && stats.waves < maxWaves && pending.size() >= minWaveSize) {
+        stats.waves++;
+        pool.parallelFor(pending.size(), [&](size_t i, unsigned w) {
+            int agent = pending[i];
+            found[agent] = grid.isWalkable(agents[agent].position)
+                           && searchWindow(workers[w], grid, landmarks, agent, agents[agent], candidates[agent]);
+            expanded[agent] += workers[w].expanded;
+        });
+
+        vector<int> clashed;
+        for (int agent : pending) {
+            if (found[agent] && !clashes(agent, candidates[agent], grid)) {
+                commit(agent, candidates[agent], grid);
+                agents[agent].plan = move(candidates[agent]);
+            } else if (found[agent]) {
+                clashed.push_back(agent);
+                stats.rejected++;
+            } else {
+                // No way round the agents before it even with nothing else committed; try again last
+                clashed.push_back(agent);
+            }
+        }
+        pending.swap(clashed);
+    }
+
+    // The rest one at a time, each seeing every plan committed before it. An agent with no
+    // way round the others has to stand still; whoever planned through its tile is sent
+    // back to replan around it. Waiting agents never clash with each other (they stand on
+    // different tiles), so each one bumps a few others at most once and this ends.
+    for (size_t next = 0; next < pending.size(); ++next) {
+        int agent = pending[next];
+        stats.serial++;
+        Agent& a = agents[agent];
+        bool ok = grid.isWalkable(a.position) && searchWindow(workers[0], grid, landmarks, agent, a, candidates[agent]);
+        expanded[agent] += workers[0].expanded;
+        if (ok) {
+            a.plan = move(candidates[agent]);
+        } else {
+            a.plan.assign(window, a.position);
+            stats.waiting++;
+            const int tile = grid.index(a.position);
+            for (int k = 1; k < window; ++k) {
+                int other = reservations.holderOf(tile, roundStart + k);
+                if (other < 0 || other == agent) continue;
+                // Keep only where it stands now; the rest of its plan is replanned
+                for (int j = 1; j < window; ++j) {
+                    int cell = grid.index(agents[other].plan[j]);
+                    if (reservations.holderOf(cell, roundStart + j) == other) reservations.release(cell, roundStart + j);
+                }
+                pending.push_back(other);
+                stats.bumped++;
+            }
+        }
+        commit(agent, a.plan, grid);
+    }
+
+    for (int count : expanded) stats.expanded += count;
+    planned = static_cast<int>(agents.size());
+    stats.wallMs = chrono::duration<double, milli>(chrono::steady_clock::now() - began).count();
+    return stats;
+}
+
+int CooperativePlanner::countConflicts(const vector<Agent>& agents) const {
+    // (step, tile) of every planned cell, sorted so that equal cells sit next to each other
+    vector<pair<long long, int>> cells;
+    for (size_t i = 0; i < agents.size(); ++i) {
+        for (size_t k = 0; k < agents[i].plan.size(); ++k) {
+            sf::Vector2i t = agents[i].plan[k];
+            long long key = (static_cast<long long>(k) << 40) | (static_cast<long long>(t.y) << 20) | t.x;
+            cells.push_back({key, static_cast<int>(i)});
+        }
+    }
+    sort(cells.begin(), cells.end());
+    int conflicts = 0;
+    for (size_t i = 1; i < cells.size(); ++i) {
+        if (cells[i].first == cells[i - 1].first) conflicts++;
+    }
+    return conflicts;
+}
+
+void CooperativePlanner::advance(vector<Agent>& agents, int steps) {
+    steps = min(steps, window - 1);
+    for (Agent& a : agents) {
+        if (static_cast<int>(a.plan.size()) <= steps) continue;
+        a.position = a.plan[steps];
+        a.plan.erase(a.plan.begin(), a.plan.begin() + steps);
+    }
+    roundStart += steps;
+}
@@ -0,0 +1,196 @@
+#include "DStarLite.h"
+#include <algorithm>
+#include <functional>
+#include <climits>
+#include <cstdlib>
+
+using namespace std;
+
+namespace {
+const int INF = INT_MAX / 4;
+const int dx[4] = {1, -1, 0, 0};
+const int dy[4] = {0, 0, 1, -1};
+}
+
+int DStarLite::heuristic(int tile) const {
+    sf::Vector2i t = grid.tile(tile);
+    return abs(t.x - start.x) + abs(t.y - start.y);
+}
+
+void DStarLite::calculateKey(int tile, int& k1, int& k2) const {
+    k2 = min(g[tile], rhs[tile]);
+    k1 = k2 >= INF ? INF : k2 + heuristic(tile) + km;
+}
+
+void DStarLite::push(int tile) {
+    calculateKey(tile, key1[tile], key2[tile]);
+    queued[tile] = 1;
+    open.push_back({key1[tile], key2[tile], tile});
+    push_heap(open.begin(), open.end(), greater<OpenEntry>());
+}
+
+void DStarLite::updateVertex(int tile) {
+    int goalIndex = grid.index(goal);
+    if (tile != goalIndex) {
+        int best = INF;
+        if (grid.walkable[tile]) {
+            int x = tile % grid.width;
+            int y = tile / grid.width;
+            for (int d = 0; d < 4; ++d) {
+                if (!grid.isWalkable(x + dx[d], y + dy[d])) continue;
+                int next = grid.index(x + dx[d], y + dy[d]);
+                if (g[next] < INF) best = min(best, g[next] + 1);
+            }
+        }
+        rhs[tile] = best;
+    }
+
+    queued[tile] = 0; // any heap entry left behind becomes stale
+    if (g[tile] != rhs[tile]) push(tile);
+}
+
+void DStarLite::setGoal(const Map& map, sf::Vector2i from, sf::Vector2i destination) {
+    grid.syncFrom(map);
+    int count = grid.tileCount();
+    g.assign(count, INF);
+    rhs.assign(count, INF);
+    key1.assign(count, 0);
+    key2.assign(count, 0);
+    queued.assign(count, 0);
+    open.clear();
+
+    start = lastStart = from;
+    goal = destination;
+    km = 0;
+    active = grid.isWalkable(goal);
+    dirty = true;
+
+    if (active) {
+        rhs[grid.index(goal)] = 0;
+        push(grid.index(goal));
+    }
+}
+
+void DStarLite::moveStart(sf::Vector2i tile) {
+    if (tile == start) return;
+    start = tile;
+    dirty = true;
+}
+
+void DStarLite::tileChanged(int tile) {
+    int x = tile % grid.width;
+    int y = tile / grid.width;
+    updateVertex(tile);
+    for (int d = 0; d < 4; ++d) {
+        if (grid.inBounds(x + dx[d], y + dy[d])) updateVertex(grid.index(x + dx[d], y + dy[d]));
+    }
+}
+
+void DStarLite::sync(const Map& map) {
+    if (!active) return;
+
+    GridChange change = grid.syncFrom(map);
+    if (change == GridChange::Rebuilt) {
+        // Regenerated lava can change any tile; start over towards the same goal
+        setGoal(map, start, goal);
+        return;
+    }
+    if (change != GridChange::Patched || grid.changedTiles.empty()) return;
+
+    catchUpStart();
+    for (int tile : grid.changedTiles) tileChanged(tile);
+    if (!grid.walkable[grid.index(goal)]) active = false;
+    dirty = true;
+}
+
+// Keys already queued were computed from an older start; adding how far the start
+// has moved since then to km keeps them valid lower bounds
+void DStarLite::catchUpStart() {
+    km += abs(lastStart.x - start.x) + abs(lastStart.y - start.y);
+    lastStart = start;
+}
+
+bool DStarLite::replan() {
+    nodesExpanded = 0;
+    if (!active || !dirty) return false;
+    dirty = false;
+    catchUpStart();
+    if (!grid.isWalkable(start)) return true;
+    computeShortestPath();
+    return true;
+}
+
+void DStarLite::computeShortestPath() {
+    const int startIndex = grid.index(start);
+    const greater<OpenEntry> minHeap;
+
+    while (!open.empty()) {
+        OpenEntry top = open.front();
+        if (!queued[top.tile] || top.k1 != key1[top.tile] || top.k2 != key2[top.tile]) {
+            pop_heap(open.begin(), open.end(), minHeap);
+            open.pop_back();
+            continue;
+        }
+
+        int startK1, startK2;
+        calculateKey(startIndex, startK1, startK2);
+        bool topBeforeStart = top.k1 < startK1 || (top.k1 == startK1 && top.k2 < startK2);
+        if (!topBeforeStart && rhs[startIndex] <= g[startIndex]) break;
+
+        pop_heap(open.begin(), open.end(), minHeap);
+        open.pop_back();
+
+        int u = top.tile;
+        int newK1, newK2;
+        calculateKey(u, newK1, newK2);
+
+        if (top.k1 < newK1 || (top.k1 == newK1 && top.k2 < newK2)) {
+            push(u); // key is out of date because the start moved
+            continue;
+        }
+
+        nodesExpanded++;
+        queued[u] = 0;
+
+        int x = u % grid.width;
+        int y = u / grid.width;
+        if (g[u] > rhs[u]) {
+            g[u] = rhs[u];
+        } else {
+            g[u] = INF;
+            updateVertex(u);
+        }
+        for (int d = 0; d < 4; ++d) {
+            if (grid.inBounds(x + dx[d], y + dy[d])) updateVertex(grid.index(x + dx[d], y + dy[d]));
+        }
+    }
+}
+
+vector<sf::Vector2i> DStarLite::getPath() const {
+    vector<sf::Vector2i> path;
+    // The start itself may be left overconsistent, so its rhs is the cost to trust
+    if (!active || !grid.isWalkable(start) || rhs[grid.index(start)] >= INF) return path;
+
+    int current = grid.index(start);
+    int goalIndex = grid.index(goal);
+    path.push_back(start);
+
+    while (current != goalIndex && static_cast<int>(path.size()) <= grid.tileCount()) {
+        int x = current % grid.width;
+        int y = current / grid.width;
+        int best = -1;
+        int bestCost = INF;
+        for (int d = 0; d < 4; ++d) {
+            if (!grid.isWalkable(x + dx[d], y + dy[d])) continue;
+            int next = grid.index(x + dx[d], y + dy[d]);
+            if (g[next] < bestCost) {
+                bestCost = g[next];
+                best = next;
+            }
+        }
+        if (best < 0) return {};
+        current = best;
+        path.push_back(grid.tile(current));
+    }
+    return path;
+}
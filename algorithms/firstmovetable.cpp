@@ -0,0 +1,356 @@
+#include "FirstMoveTable.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+namespace {
+
+const int dx[4] = {1, -1, 0, 0};
+const int dy[4] = {0, 0, 1, -1};
+const char fileMagic[4] = {'L', 'C', 'P', 'D'};
+const uint32_t fileVersion = 2;
+
+template <typename T>
+void writeArray(ofstream& out, const vector<T>& values) {
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<streamsize>(values.size() * sizeof(T)));
+}
+
+template <typename T>
+bool readArray(ifstream& in, vector<T>& values, size_t count) {
+    values.resize(count);
+    in.read(reinterpret_cast<char*>(values.data()), static_cast<streamsize>(count * sizeof(T)));
+    return static_cast<bool>(in);
+}
+
+// The grid with a ring of lava around it, so the BFS needs no bounds checks or divisions
+struct PaddedGrid {
+    int stride = 0;
+    vector<unsigned char> walkable;
+    vector<int> order;           // the table's order, in padded indices
+    int steps[4] = {0, 0, 0, 0}; // index offset of each direction
+
+    PaddedGrid(const SearchGrid& grid, const vector<int>& tableOrder) : stride(grid.width + 2) {
+        walkable.assign(static_cast<size_t>(stride) * (grid.height + 2), 0);
+        for (int i = 0; i < grid.tileCount(); ++i) walkable[toPadded(grid, i)] = grid.walkable[i];
+        for (int tile : tableOrder) order.push_back(toPadded(grid, tile));
+        for (int d = 0; d < 4; ++d) steps[d] = dy[d] * stride + dx[d];
+    }
+
+    int toPadded(const SearchGrid& grid, int tile) const { return (tile / grid.width + 1) * stride + tile % grid.width + 1; }
+};
+
+// Per-thread BFS state; distance is -1 everywhere between searches
+struct BuildScratch {
+    vector<int> distance;
+    vector<unsigned char> moves; // directions out of the source that start a shortest path here
+    vector<int> queue;
+};
+
+// Run-length encoded row of one source, covering only the ranks of its own region
+void encodeRow(const PaddedGrid& grid, int source, int regionBegin, int regionEnd, BuildScratch& scratch, vector<uint32_t>& out) {
+    vector<int>& distance = scratch.distance;
+    vector<unsigned char>& moves = scratch.moves;
+    vector<int>& queue = scratch.queue;
+
+    // BFS that carries the set of first moves along: a tile one layer further out
+    // inherits the moves of every neighbour one layer closer
+    queue.clear();
+    distance[source] = 0;
+    queue.push_back(source);
+    for (int d = 0; d < 4; ++d) {
+        int next = source + grid.steps[d];
+        if (!grid.walkable[next]) continue;
+        distance[next] = 1;
+        moves[next] = static_cast<unsigned char>(1 << d);
+        queue.push_back(next);
+    }
+    for (size_t head = 1; head < queue.size(); ++head) {
+        int current = queue[head];
+        int nextDistance = distance[current] + 1;
+        for (int d = 0; d < 4; ++d) {
+            int next = current + grid.steps[d];
+            if (!grid.walkable[next]) continue;
+            if (distance[next] < 0) {
+                distance[next] = nextDistance;
+                moves[next] = moves[current];
+                queue.push_back(next);
+            } else if (distance[next] == nextDistance) {
+                moves[next] |= moves[current];
+            }
+        }
+    }
+
+    // Greedy runs: keep narrowing the moves the run can use until a destination allows none of them
+    unsigned allowed = 0xF;
+    uint32_t runBegin = static_cast<uint32_t>(regionBegin);
+    auto emit = [&] {
+        int direction = 0;
+        while (!(allowed >> direction & 1)) ++direction;
+        out.push_back(runBegin << 2 | static_cast<uint32_t>(direction));
+    };
+    for (int r = regionBegin; r < regionEnd; ++r) {
+        int tile = grid.order[r];
+        unsigned wanted = tile == source ? 0xF : moves[tile];
+        if (allowed & wanted) {
+            allowed &= wanted;
+            continue;
+        }
+        emit();
+        runBegin = static_cast<uint32_t>(r);
+        allowed = wanted;
+    }
+    emit();
+
+    for (int tile : queue) distance[tile] = -1;
+}
+
+} // namespace
+
+shared_ptr<FirstMoveTable> FirstMoveTable::build(const SearchGrid& grid, unsigned threadCount) {
+    auto began = chrono::steady_clock::now();
+    auto table = make_shared<FirstMoveTable>();
+    table->layout = grid.layout;
+    table->walkableHash = hashWalkable(grid);
+    table->width = grid.width;
+    table->height = grid.height;
+    table->rank.assign(grid.tileCount(), -1);
+
+    // Depth-first preorder, one region after another, so each region is one range of ranks
+    vector<int> regionBegins;
+    vector<int> stack;
+    for (int seed = 0; seed < grid.tileCount(); ++seed) {
+        if (!grid.walkable[seed] || table->rank[seed] >= 0) continue;
+        int region = static_cast<int>(regionBegins.size());
+        regionBegins.push_back(static_cast<int>(table->order.size()));
+        stack.push_back(seed);
+        while (!stack.empty()) {
+            int current = stack.back();
+            stack.pop_back();
+            if (table->rank[current] >= 0) continue;
+            table->rank[current] = static_cast<int>(table->order.size());
+            table->order.push_back(current);
+            table->component.push_back(region);
+            int x = current % grid.width;
+            int y = current / grid.width;
+            for (int d = 3; d >= 0; --d) {
+                if (grid.isWalkable(x + dx[d], y + dy[d]) && table->rank[grid.index(x + dx[d], y + dy[d])] < 0) {
+                    stack.push_back(grid.index(x + dx[d], y + dy[d]));
+                }
+            }
+        }
+    }
+    regionBegins.push_back(static_cast<int>(table->order.size()));
+
+    // Rows are built in chunks of tiles so each thread appends to its own run list
+    const int chunkSize = 256;
+    const int chunkCount = (grid.tileCount() + chunkSize - 1) / chunkSize;
+    vector<vector<uint32_t>> chunkRuns(chunkCount);
+    vector<vector<uint32_t>> chunkRowEnds(chunkCount);
+    PaddedGrid padded(grid, table->order);
+    ThreadPool pool(threadCount);
+    vector<BuildScratch> scratch(pool.size());
+    for (BuildScratch& s : scratch) {
+        s.distance.assign(padded.walkable.size(), -1);
+        s.moves.assign(padded.walkable.size(), 0);
+    }
+    pool.parallelFor(chunkCount, [&](size_t chunk, unsigned worker) {
+        int first = static_cast<int>(chunk) * chunkSize;
+        int last = min(grid.tileCount(), first + chunkSize);
+        for (int tile = first; tile < last; ++tile) {
+            if (table->rank[tile] >= 0) {
+                int region = table->component[table->rank[tile]];
+                encodeRow(padded, padded.toPadded(grid, tile), regionBegins[region], regionBegins[region + 1], scratch[worker], chunkRuns[chunk]);
+            }
+            chunkRowEnds[chunk].push_back(static_cast<uint32_t>(chunkRuns[chunk].size()));
+        }
+    });
+
+    table->rowStart.reserve(grid.tileCount() + 1);
+    table->rowStart.push_back(0);
+    for (int chunk = 0; chunk < chunkCount; ++chunk) {
+        uint32_t offset = static_cast<uint32_t>(table->runs.size());
+        for (uint32_t end : chunkRowEnds[chunk]) table->rowStart.push_back(offset + end);
+        table->runs.insert(table->runs.end(), chunkRuns[chunk].begin(), chunkRuns[chunk].end());
+        vector<uint32_t>().swap(chunkRuns[chunk]);
+    }
+    table->buildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - began).count();
+    return table;
+}
+
+bool FirstMoveTable::save(const string& path) const {
+    ofstream out(path, ios::binary);
+    if (!out) return false;
+    int32_t header[4] = {width, height, static_cast<int32_t>(order.size()), static_cast<int32_t>(runs.size())};
+    out.write(fileMagic, sizeof(fileMagic));
+    out.write(reinterpret_cast<const char*>(&fileVersion), sizeof(fileVersion));
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(&walkableHash), sizeof(walkableHash));
+    writeArray(out, order);
+    writeArray(out, component);
+    writeArray(out, rowStart);
+    writeArray(out, runs);
+    return static_cast<bool>(out);
+}
+
+shared_ptr<FirstMoveTable> FirstMoveTable::load(const string& path) {
+    ifstream in(path, ios::binary);
+    if (!in) return nullptr;
+    char magic[4];
+    uint32_t version = 0;
+    int32_t header[4];
+    uint64_t hash = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    in.read(reinterpret_cast<char*>(&hash), sizeof(hash));
+    if (!in || !equal(magic, magic + 4, fileMagic) || version != fileVersion) return nullptr;
+    if (header[0] <= 0 || header[1] <= 0 || header[2] < 0 || header[3] < 0
+        || static_cast<long long>(header[2]) > static_cast<long long>(header[0]) * header[1]) return nullptr;
+
+    auto table = make_shared<FirstMoveTable>();
+    table->walkableHash = hash;
+    table->width = header[0];
+    table->height = header[1];
+    if (!readArray(in, table->order, header[2]) || !readArray(in, table->component, header[2])
+        || !readArray(in, table->rowStart, static_cast<size_t>(header[0]) * header[1] + 1) || !readArray(in, table->runs, header[3])) return nullptr;
+
+    // Reject anything a lookup could index out of range with
+    if (table->rowStart.front() != 0 || table->rowStart.back() != table->runs.size()) return nullptr;
+    if (!is_sorted(table->rowStart.begin(), table->rowStart.end())) return nullptr;
+    table->rank.assign(static_cast<size_t>(table->width) * table->height, -1);
+    for (size_t r = 0; r < table->order.size(); ++r) {
+        int tile = table->order[r];
+        if (tile < 0 || tile >= static_cast<int>(table->rank.size()) || table->rank[tile] >= 0) return nullptr;
+        if (table->rowStart[tile] >= table->rowStart[tile + 1]) return nullptr;
+        table->rank[tile] = static_cast<int>(r);
+    }
+    return table;
+}
+
+uint64_t FirstMoveTable::hashWalkable(const SearchGrid& grid) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint64_t byte) {
+        hash ^= byte;
+        hash *= 1099511628211ull;
+    };
+    for (int shift = 0; shift < 32; shift += 8) {
+        mix(static_cast<uint32_t>(grid.width) >> shift & 0xFF);
+        mix(static_cast<uint32_t>(grid.height) >> shift & 0xFF);
+    }
+    for (unsigned char tile : grid.walkable) mix(tile);
+    return hash;
+}
+
+bool FirstMoveTable::fits(const SearchGrid& grid) const {
+    if (grid.width != width || grid.height != height) return false;
+    for (int i = 0; i < grid.tileCount(); ++i) {
+        if (grid.walkable[i] && rank[i] < 0) return false;
+    }
+    return true;
+}
+
+size_t FirstMoveTable::bytes() const {
+    return (order.size() + rank.size() + component.size()) * sizeof(int)
+           + (rowStart.size() + runs.size()) * sizeof(uint32_t);
+}
+
+int FirstMoveTable::firstMove(int source, int target) const {
+    int sourceRank = rank[source];
+    int targetRank = rank[target];
+    if (sourceRank < 0 || targetRank < 0 || sourceRank == targetRank) return -1;
+    if (component[sourceRank] != component[targetRank]) return -1;
+    auto rowBegin = runs.begin() + rowStart[source];
+    auto rowEnd = runs.begin() + rowStart[source + 1];
+    // The run holding targetRank is the last one starting at or before it
+    auto after = upper_bound(rowBegin, rowEnd, static_cast<uint32_t>(targetRank) << 2 | 3u);
+    return static_cast<int>(*(after - 1) & 3u);
+}
+
+SearchResult FirstMoveTable::findPath(const SearchGrid& grid, sf::Vector2i start, sf::Vector2i goal) const {
+    auto began = chrono::steady_clock::now();
+    SearchResult result;
+    auto finish = [&](SearchFailure failure) {
+        if (failure != SearchFailure::None) result.path.clear();
+        result.stats.failure = failure;
+        result.stats.wallMs = chrono::duration<double, milli>(chrono::steady_clock::now() - began).count();
+        return result;
+    };
+    if (!grid.isWalkable(start)) return finish(SearchFailure::StartBlocked);
+    if (!grid.isWalkable(goal)) return finish(SearchFailure::GoalBlocked);
+
+    // fits() scans the whole grid, so it is remembered for the grid version it passed on.
+    // Grids that weren't synced from a map have no version and are always scanned.
+    const uint64_t stamp = static_cast<uint64_t>(grid.layout) << 32 | grid.version;
+    if (grid.version == ~0u || fittedGrid.load(memory_order_relaxed) != stamp) {
+        if (!fits(grid)) return finish(SearchFailure::Outdated);
+        if (grid.version != ~0u) fittedGrid.store(stamp, memory_order_relaxed);
+    }
+
+    int current = grid.index(start);
+    const int target = grid.index(goal);
+    if (rank[current] < 0 || rank[target] < 0) return finish(SearchFailure::Outdated);
+    if (component[rank[current]] != component[rank[target]]) return finish(SearchFailure::Unreachable);
+
+    // Every step gets one closer to the goal on the table's grid, so this ends. Only the
+    // tiles on the way are walkable on that grid, so each has a row holding the goal's rank.
+    const uint32_t targetKey = static_cast<uint32_t>(rank[target]) << 2 | 3u;
+    result.path.push_back(start);
+    while (current != target) {
+        auto after = upper_bound(runs.begin() + rowStart[current], runs.begin() + rowStart[current + 1], targetKey);
+        int d = static_cast<int>(*(after - 1) & 3u);
+        int x = current % width + dx[d];
+        int y = current / width + dy[d];
+        if (!grid.isWalkable(x, y)) return finish(SearchFailure::Outdated);
+        current = grid.index(x, y);
+        result.path.emplace_back(x, y);
+    }
+    return finish(SearchFailure::None);
+}
+
+void FirstMoves::sync(const Map& map) {
+    unsigned previousLayout = grid.layout;
+    grid.syncFrom(map);
+    if (grid.layout != previousLayout) {
+        table.reset();
+        layoutGrid = grid;
+        layoutHash = FirstMoveTable::hashWalkable(grid);
+    }
+
+    if (isBuilding() && building.wait_for(chrono::seconds(0)) == future_status::ready) {
+        auto built = building.get();
+        if (built->layout == grid.layout) {
+            table = built;
+            justFinished = true;
+        }
+    }
+}
+
+bool FirstMoves::request(const string& file) {
+    if (table) return true;
+    if (isBuilding()) return false;
+
+    auto loaded = FirstMoveTable::load(file);
+    if (loaded && loaded->walkableHash == layoutHash && loaded->fits(grid)) {
+        loaded->layout = grid.layout;
+        table = loaded;
+        return true;
+    }
+
+    auto snapshot = make_shared<const SearchGrid>(layoutGrid);
+    building = async(launch::async, [snapshot, file] {
+        auto built = FirstMoveTable::build(*snapshot);
+        if (!built->save(file)) cerr << "Failed to save first-move table: " << file << "\n";
+        return built;
+    });
+    return false;
+}
+
+bool FirstMoves::takeFinished() {
+    bool finished = justFinished;
+    justFinished = false;
+    return finished;
+}
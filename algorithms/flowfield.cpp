@@ -0,0 +1,188 @@
+#include "FlowField.h"
+#include <algorithm>
+#include <functional>
+
+using namespace std;
+
+namespace {
+const int dx[4] = {1, -1, 0, 0};
+const int dy[4] = {0, 0, 1, -1};
+const int opposite[4] = {1, 0, 3, 2};
+}
+
+bool FlowField::setGoal(const Map& map, sf::Vector2i destination) {
+    grid.syncFrom(map);
+    goal = destination;
+    active = grid.isWalkable(goal);
+    if (active) build();
+    return active;
+}
+
+void FlowField::build() {
+    const int width = grid.width;
+    distance.assign(grid.tileCount(), INT_MAX);
+    nextStep.assign(grid.tileCount(), -1);
+
+    // Plain BFS from the goal; each tile points back at the tile that reached it
+    vector<int> queue;
+    queue.reserve(grid.tileCount());
+    int goalIndex = grid.index(goal);
+    distance[goalIndex] = 0;
+    queue.push_back(goalIndex);
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int current = queue[head];
+        int x = current % width;
+        int y = current / width;
+        for (int d = 0; d < 4; ++d) {
+            int nx = x + dx[d];
+            int ny = y + dy[d];
+            if (!grid.isWalkable(nx, ny)) continue;
+            int next = ny * width + nx;
+            if (distance[next] != INT_MAX) continue;
+            distance[next] = distance[current] + 1;
+            nextStep[next] = static_cast<signed char>(opposite[d]);
+            queue.push_back(next);
+        }
+    }
+    tilesUpdated = static_cast<int>(queue.size());
+}
+
+bool FlowField::sync(const Map& map) {
+    if (!active) return false;
+
+    GridChange change = grid.syncFrom(map);
+    if (change == GridChange::None) return false;
+
+    if (change == GridChange::Rebuilt || !grid.isWalkable(goal)) {
+        active = grid.isWalkable(goal);
+        if (active) build();
+        return true;
+    }
+
+    repair(grid.changedTiles);
+    return tilesUpdated > 0;
+}
+
+// Closing tiles can only lengthen distances. A tile keeps its distance d exactly when a
+// neighbour still at d - 1 does, so tiles are re-checked in order of their old distance,
+// starting from the ones that stepped into new lava; a tile that loses every such
+// neighbour is invalidated and its own dependants are re-checked. The invalidated tiles
+// then get their new distances from a Dijkstra seeded off the surviving tiles around them.
+void FlowField::repair(const vector<int>& closedTiles) {
+    const int width = grid.width;
+    const greater<pair<int, int>> minHeap;
+    tilesUpdated = 0;
+    heap.clear();
+    invalidated.clear();
+
+    auto pushDependants = [&](int tile) {
+        int x = tile % width;
+        int y = tile / width;
+        for (int d = 0; d < 4; ++d) {
+            int nx = x + dx[d];
+            int ny = y + dy[d];
+            if (!grid.isWalkable(nx, ny)) continue;
+            int next = ny * width + nx;
+            if (nextStep[next] == opposite[d]) {
+                heap.push_back({distance[next], next});
+                push_heap(heap.begin(), heap.end(), minHeap);
+            }
+        }
+    };
+
+    for (int tile : closedTiles) {
+        if (distance[tile] == INT_MAX) continue;
+        pushDependants(tile);
+        distance[tile] = INT_MAX;
+        nextStep[tile] = -1;
+        tilesUpdated++;
+    }
+
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), minHeap);
+        auto [oldDistance, tile] = heap.back();
+        heap.pop_back();
+        if (distance[tile] != oldDistance) continue; // already invalidated
+
+        int x = tile % width;
+        int y = tile / width;
+        int support = -1;
+        for (int d = 0; d < 4 && support < 0; ++d) {
+            int nx = x + dx[d];
+            int ny = y + dy[d];
+            if (grid.isWalkable(nx, ny) && distance[ny * width + nx] == oldDistance - 1) support = d;
+        }
+        if (support >= 0) {
+            nextStep[tile] = static_cast<signed char>(support);
+            continue;
+        }
+
+        pushDependants(tile);
+        distance[tile] = INT_MAX;
+        nextStep[tile] = -1;
+        invalidated.push_back(tile);
+        tilesUpdated++;
+    }
+
+    // Re-grow the invalidated region from its surviving border
+    for (int tile : invalidated) {
+        int x = tile % width;
+        int y = tile / width;
+        for (int d = 0; d < 4; ++d) {
+            int nx = x + dx[d];
+            int ny = y + dy[d];
+            if (!grid.isWalkable(nx, ny)) continue;
+            int neighbour = distance[ny * width + nx];
+            if (neighbour != INT_MAX && neighbour + 1 < distance[tile]) {
+                distance[tile] = neighbour + 1;
+                nextStep[tile] = static_cast<signed char>(d);
+            }
+        }
+        if (distance[tile] != INT_MAX) {
+            heap.push_back({distance[tile], tile});
+            push_heap(heap.begin(), heap.end(), minHeap);
+        }
+    }
+
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), minHeap);
+        auto [cost, tile] = heap.back();
+        heap.pop_back();
+        if (cost != distance[tile]) continue;
+
+        int x = tile % width;
+        int y = tile / width;
+        for (int d = 0; d < 4; ++d) {
+            int nx = x + dx[d];
+            int ny = y + dy[d];
+            if (!grid.isWalkable(nx, ny)) continue;
+            int next = ny * width + nx;
+            if (cost + 1 >= distance[next]) continue;
+            distance[next] = cost + 1;
+            nextStep[next] = static_cast<signed char>(opposite[d]);
+            heap.push_back({cost + 1, next});
+            push_heap(heap.begin(), heap.end(), minHeap);
+        }
+    }
+}
+
+int FlowField::distanceFrom(sf::Vector2i tile) const {
+    if (!active || !grid.isWalkable(tile)) return INT_MAX;
+    return distance[grid.index(tile)];
+}
+
+vector<sf::Vector2i> FlowField::pathFrom(sf::Vector2i tile) const {
+    vector<sf::Vector2i> path;
+    if (distanceFrom(tile) == INT_MAX) return path;
+
+    path.reserve(distance[grid.index(tile)] + 1);
+    path.push_back(tile);
+    while (tile != goal) {
+        int d = nextStep[grid.index(tile)];
+        tile.x += dx[d];
+        tile.y += dy[d];
+        path.push_back(tile);
+    }
+    return path;
+}
@@ -0,0 +1,158 @@
+#include "HashDistributedAStar.h"
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <thread>
+
+using namespace std;
+
+HashDistributedAStar::HashDistributedAStar(unsigned threadCount, int blockSize)
+    : pool(threadCount), blockShift(0) {
+    while ((2 << blockShift) <= blockSize) blockShift++;
+    for (unsigned i = 0; i < pool.size(); ++i) {
+        partitions.push_back(make_unique<Partition>());
+        partitions.back()->outbox.resize(pool.size());
+    }
+}
+
+unsigned HashDistributedAStar::ownerOf(int x, int y) const {
+    // Fibonacci hashing of the block coordinates
+    uint32_t block = static_cast<uint32_t>(x >> blockShift) * 73856093u ^ static_cast<uint32_t>(y >> blockShift) * 19349663u;
+    return static_cast<unsigned>((static_cast<uint64_t>(block * 2654435769u) * pool.size()) >> 32);
+}
+
+SearchResult HashDistributedAStar::findPath(const SearchGrid& grid, sf::Vector2i start, sf::Vector2i goal) {
+    auto began = chrono::steady_clock::now();
+    SearchResult result;
+    SearchStats& stats = result.stats;
+    messages = 0;
+    auto finish = [&](SearchFailure failure) {
+        stats.failure = failure;
+        stats.wallMs = chrono::duration<double, milli>(chrono::steady_clock::now() - began).count();
+        return result;
+    };
+    if (!grid.isWalkable(start)) return finish(SearchFailure::StartBlocked);
+    if (!grid.isWalkable(goal)) return finish(SearchFailure::GoalBlocked);
+
+    const int startIndex = grid.index(start);
+    const int goalIndex = grid.index(goal);
+    workspace.reset(grid.tileCount());
+    workspace.set(startIndex, 0, -1);
+    incumbent = startIndex == goalIndex ? 0 : INT_MAX;
+    for (auto& p : partitions) {
+        p->open.clear();
+        p->credits = 0;
+        p->sent = 0;
+        p->stats = SearchStats();
+    }
+
+    // The start counts as a message its owner has received, so the search can't look
+    // finished before the owner has expanded it
+    Partition& first = *partitions[ownerOf(start.x, start.y)];
+    first.open.push(abs(start.x - goal.x) + abs(start.y - goal.y), startIndex);
+    first.credits = 1;
+    outstanding = 1;
+
+    pool.parallelFor(partitions.size(), [&](size_t self, unsigned) {
+        run(static_cast<unsigned>(self), grid, goal);
+    });
+
+    for (const auto& p : partitions) {
+        stats.expanded += p->stats.expanded;
+        stats.pushed += p->stats.pushed;
+        stats.stalePops += p->stats.stalePops;
+        stats.peakOpen = max(stats.peakOpen, p->stats.peakOpen);
+        messages += p->sent;
+    }
+    if (incumbent == INT_MAX) return finish(SearchFailure::Unreachable);
+    result.path = tracePath(grid, workspace, startIndex, goalIndex);
+    return finish(SearchFailure::None);
+}
+
+// One thread's loop: take in what the others sent, expand a batch of its own tiles, post
+// what it found for the others, and repeat until the search is over.
+//
+// Termination: every message adds one to outstanding before it is posted, and its receiver
+// takes it off only once it has nothing left to do (inbox and open list both empty).
+// Anything a message leads to is posted before the message itself is accounted for, so
+// outstanding stays above zero while any thread still has work, and zero means done.
+void HashDistributedAStar::run(unsigned self, const SearchGrid& grid, sf::Vector2i goal) {
+    const int dx[4] = {1, -1, 0, 0};
+    const int dy[4] = {0, 0, 1, -1};
+    const unsigned threads = pool.size();
+    const int goalIndex = grid.index(goal);
+    Partition& me = *partitions[self];
+    auto heuristic = [&](int x, int y) { return abs(x - goal.x) + abs(y - goal.y); };
+
+    auto lowerIncumbent = [&](int cost) {
+        int best = incumbent.load();
+        while (cost < best && !incumbent.compare_exchange_weak(best, cost)) {}
+    };
+    // A tile this thread owns was reached with cost from parent
+    auto relax = [&](int tile, int cost, int parent) {
+        if (cost >= workspace.costOf(tile)) return;
+        workspace.set(tile, cost, parent);
+        if (tile == goalIndex) {
+            lowerIncumbent(cost);
+            return;
+        }
+        me.open.push(cost + heuristic(tile % grid.width, tile / grid.width), tile);
+        me.stats.onPush(me.open.size());
+    };
+
+    while (true) {
+        bool inboxEmpty = me.inbox.drain([&](vector<Message>& batch) {
+            me.credits += static_cast<long long>(batch.size());
+            for (const Message& m : batch) relax(m.tile, m.cost, m.parent);
+        }) == 0;
+
+        // A batch of expansions between looking at the inbox
+        for (int batch = 0; batch < 64 && !me.open.empty(); ++batch) {
+            auto [priority, tile] = me.open.pop();
+            int x = tile % grid.width;
+            int y = tile / grid.width;
+            int cost = workspace.costOf(tile);
+            if (priority - heuristic(x, y) > cost) {
+                me.stats.onStalePop();
+                continue;
+            }
+            // Nothing left here can beat the best goal path; the bound only gets tighter
+            if (priority >= incumbent.load(memory_order_relaxed)) {
+                me.open.clear();
+                break;
+            }
+            me.stats.onExpand();
+            for (int d = 0; d < 4; ++d) {
+                int nx = x + dx[d];
+                int ny = y + dy[d];
+                if (!grid.isWalkable(nx, ny)) continue;
+                int nextCost = cost + 1;
+                if (nextCost + heuristic(nx, ny) >= incumbent.load(memory_order_relaxed)) continue;
+                int next = grid.index(nx, ny);
+                unsigned owner = ownerOf(nx, ny);
+                if (owner == self) {
+                    relax(next, nextCost, tile);
+                } else {
+                    me.outbox[owner].push_back({next, nextCost, tile});
+                }
+            }
+        }
+        for (unsigned to = 0; to < threads; ++to) {
+            vector<Message>& pending = me.outbox[to];
+            if (pending.empty()) continue;
+            outstanding += static_cast<long long>(pending.size());
+            me.sent += static_cast<long long>(pending.size());
+            partitions[to]->inbox.post(move(pending));
+            pending = vector<Message>();
+        }
+
+        if (me.open.empty() && inboxEmpty) {
+            if (me.credits > 0) {
+                outstanding -= me.credits;
+                me.credits = 0;
+            }
+            if (outstanding.load() == 0) return;
+            this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,381 @@
+#include "HierarchicalPathfinder.h"
+#include <algorithm>
+#include <functional>
+#include <cstdlib>
+
+using namespace std;
+
+vector<sf::Vector2i> HpaRoute::preview() const {
+    vector<sf::Vector2i> result = tiles;
+    if (result.empty() && !waypoints.empty()) result.push_back(waypoints.front());
+    for (size_t i = refinedSegments + 1; i < waypoints.size(); ++i) result.push_back(waypoints[i]);
+    return result;
+}
+
+void HierarchicalPathfinder::sync(const Map& map) {
+    sf::Vector2i chunk = map.getChunkSize();
+    bool resized = chunk.x != clusterWidth || chunk.y != clusterHeight;
+    clusterWidth = max(1, chunk.x);
+    clusterHeight = max(1, chunk.y);
+
+    GridChange change = grid.syncFrom(map);
+    if (change == GridChange::Rebuilt || (resized && grid.width > 0)) {
+        build();
+        return;
+    }
+    if (change != GridChange::Patched) return;
+
+    vector<unsigned char> dirtyBorder(borderNodes.size(), 0);
+    vector<unsigned char> dirtyCluster(clusters.size(), 0);
+
+    for (int tile : grid.changedTiles) {
+        int x = tile % grid.width;
+        int y = tile / grid.width;
+        int cx = x / clusterWidth;
+        int cy = y / clusterHeight;
+        const Cluster& cluster = clusters[clusterOf(x, y)];
+        dirtyCluster[clusterOf(x, y)] = 1;
+
+        // Tiles on a cluster edge also decide that border's entrances
+        if (x == cluster.left && cx > 0) dirtyBorder[cy * (clustersX - 1) + cx - 1] = 1;
+        if (x == cluster.right && cx < clustersX - 1) dirtyBorder[cy * (clustersX - 1) + cx] = 1;
+        if (y == cluster.top && cy > 0) dirtyBorder[verticalBorderCount() + (cy - 1) * clustersX + cx] = 1;
+        if (y == cluster.bottom && cy < clustersY - 1) dirtyBorder[verticalBorderCount() + cy * clustersX + cx] = 1;
+    }
+
+    for (size_t border = 0; border < borderNodes.size(); ++border) {
+        if (!dirtyBorder[border]) continue;
+        // The border's old entrances live in the two clusters on either side
+        for (int node : borderNodes[border]) dirtyCluster[nodes[node].cluster] = 1;
+        buildBorder(static_cast<int>(border));
+        for (int node : borderNodes[border]) dirtyCluster[nodes[node].cluster] = 1;
+    }
+
+    for (size_t cluster = 0; cluster < clusters.size(); ++cluster) {
+        if (dirtyCluster[cluster]) buildClusterDistances(static_cast<int>(cluster));
+    }
+}
+
+void HierarchicalPathfinder::build() {
+    clustersX = (grid.width + clusterWidth - 1) / clusterWidth;
+    clustersY = (grid.height + clusterHeight - 1) / clusterHeight;
+
+    nodes.clear();
+    freeNodes.clear();
+    clusters.assign(clustersX * clustersY, Cluster());
+    for (int cy = 0; cy < clustersY; ++cy) {
+        for (int cx = 0; cx < clustersX; ++cx) {
+            Cluster& cluster = clusters[cy * clustersX + cx];
+            cluster.left = cx * clusterWidth;
+            cluster.top = cy * clusterHeight;
+            cluster.right = min(grid.width, cluster.left + clusterWidth) - 1;
+            cluster.bottom = min(grid.height, cluster.top + clusterHeight) - 1;
+        }
+    }
+
+    int borderCount = max(0, verticalBorderCount()) + max(0, (clustersY - 1) * clustersX);
+    borderNodes.assign(borderCount, vector<int>());
+    for (int border = 0; border < borderCount; ++border) buildBorder(border);
+    for (size_t cluster = 0; cluster < clusters.size(); ++cluster) buildClusterDistances(static_cast<int>(cluster));
+}
+
+// Find the entrances along one border: every run of tiles open on both sides gets
+// one entrance in its middle, or one at each end if the run is long
+void HierarchicalPathfinder::buildBorder(int border) {
+    for (int node : borderNodes[border]) {
+        vector<int>& list = clusters[nodes[node].cluster].nodes;
+        list.erase(find(list.begin(), list.end(), node));
+        freeNodes.push_back(node);
+    }
+    borderNodes[border].clear();
+
+    // Walk the border as pairs (a, b) of tiles facing each other
+    int clusterA, clusterB, length;
+    sf::Vector2i first, step, across;
+    if (border < verticalBorderCount()) {
+        int cy = border / (clustersX - 1);
+        int cx = border % (clustersX - 1);
+        clusterA = cy * clustersX + cx;
+        clusterB = clusterA + 1;
+        first = {clusters[clusterA].right, clusters[clusterA].top};
+        step = {0, 1};
+        across = {1, 0};
+        length = clusters[clusterA].bottom - clusters[clusterA].top + 1;
+    } else {
+        int index = border - verticalBorderCount();
+        int cy = index / clustersX;
+        int cx = index % clustersX;
+        clusterA = cy * clustersX + cx;
+        clusterB = clusterA + clustersX;
+        first = {clusters[clusterA].left, clusters[clusterA].bottom};
+        step = {1, 0};
+        across = {0, 1};
+        length = clusters[clusterA].right - clusters[clusterA].left + 1;
+    }
+
+    auto addEntrance = [&](int offset) {
+        sf::Vector2i a = first + step * offset;
+        sf::Vector2i b = a + across;
+        int ids[2];
+        for (int side = 0; side < 2; ++side) {
+            if (freeNodes.empty()) {
+                ids[side] = static_cast<int>(nodes.size());
+                nodes.push_back(Node());
+            } else {
+                ids[side] = freeNodes.back();
+                freeNodes.pop_back();
+            }
+        }
+        nodes[ids[0]] = {grid.index(a), clusterA, 0, ids[1]};
+        nodes[ids[1]] = {grid.index(b), clusterB, 0, ids[0]};
+        clusters[clusterA].nodes.push_back(ids[0]);
+        clusters[clusterB].nodes.push_back(ids[1]);
+        borderNodes[border].push_back(ids[0]);
+        borderNodes[border].push_back(ids[1]);
+    };
+
+    int runStart = -1;
+    for (int i = 0; i <= length; ++i) {
+        bool open = false;
+        if (i < length) {
+            sf::Vector2i a = first + step * i;
+            open = grid.isWalkable(a) && grid.isWalkable(a + across);
+        }
+        if (open && runStart < 0) runStart = i;
+        if (!open && runStart >= 0) {
+            int runLength = i - runStart;
+            if (runLength < 6) {
+                addEntrance(runStart + (runLength - 1) / 2);
+            } else {
+                addEntrance(runStart);
+                addEntrance(i - 1);
+            }
+            runStart = -1;
+        }
+    }
+}
+
+// BFS that never leaves the cluster; distances land in bfsWorkspace
+void HierarchicalPathfinder::clusterBfs(int cluster, int fromTile) {
+    const Cluster& bounds = clusters[cluster];
+    const int dx[4] = {1, -1, 0, 0};
+    const int dy[4] = {0, 0, 1, -1};
+
+    bfsWorkspace.reset(grid.tileCount());
+    bfsWorkspace.set(fromTile, 0, fromTile);
+    bfsQueue.clear();
+    bfsQueue.push_back(fromTile);
+
+    for (size_t head = 0; head < bfsQueue.size(); ++head) {
+        int current = bfsQueue[head];
+        int x = current % grid.width;
+        int y = current / grid.width;
+        int cost = bfsWorkspace.costOf(current) + 1;
+
+        for (int d = 0; d < 4; ++d) {
+            int nx = x + dx[d];
+            int ny = y + dy[d];
+            if (nx < bounds.left || nx > bounds.right || ny < bounds.top || ny > bounds.bottom) continue;
+            int next = ny * grid.width + nx;
+            if (!grid.walkable[next] || bfsWorkspace.visited(next)) continue;
+            bfsWorkspace.set(next, cost, current);
+            bfsQueue.push_back(next);
+        }
+    }
+}
+
+void HierarchicalPathfinder::buildClusterDistances(int cluster) {
+    Cluster& c = clusters[cluster];
+    int n = static_cast<int>(c.nodes.size());
+    c.distances.assign(n * n, -1);
+
+    for (int i = 0; i < n; ++i) {
+        nodes[c.nodes[i]].slot = i;
+        clusterBfs(cluster, nodes[c.nodes[i]].tile);
+        for (int j = 0; j < n; ++j) {
+            int tile = nodes[c.nodes[j]].tile;
+            if (bfsWorkspace.visited(tile)) c.distances[i * n + j] = bfsWorkspace.costOf(tile);
+        }
+    }
+}
+
+bool HierarchicalPathfinder::findRoute(const Map& map, sf::Vector2i start, sf::Vector2i goal, HpaRoute& route) {
+    sync(map);
+    route = HpaRoute();
+    nodesExplored = 0;
+
+    if (!grid.isWalkable(start) || !grid.isWalkable(goal)) return false;
+
+    const int startCluster = clusterOf(start.x, start.y);
+    const int goalCluster = clusterOf(goal.x, goal.y);
+    const Cluster& sc = clusters[startCluster];
+    const Cluster& gc = clusters[goalCluster];
+
+    // Link start and goal into the graph as two temporary nodes
+    const int startNode = static_cast<int>(nodes.size());
+    const int goalNode = startNode + 1;
+
+    clusterBfs(startCluster, grid.index(start));
+    vector<int> startLinks(sc.nodes.size(), -1);
+    for (size_t j = 0; j < sc.nodes.size(); ++j) {
+        int tile = nodes[sc.nodes[j]].tile;
+        if (bfsWorkspace.visited(tile)) startLinks[j] = bfsWorkspace.costOf(tile);
+    }
+    int directCost = -1;
+    if (startCluster == goalCluster && bfsWorkspace.visited(grid.index(goal))) {
+        directCost = bfsWorkspace.costOf(grid.index(goal));
+    }
+
+    clusterBfs(goalCluster, grid.index(goal));
+    vector<int> goalLinks(gc.nodes.size(), -1);
+    for (size_t j = 0; j < gc.nodes.size(); ++j) {
+        int tile = nodes[gc.nodes[j]].tile;
+        if (bfsWorkspace.visited(tile)) goalLinks[j] = bfsWorkspace.costOf(tile);
+    }
+
+    auto tileOf = [&](int node) {
+        if (node == startNode) return start;
+        if (node == goalNode) return goal;
+        return grid.tile(nodes[node].tile);
+    };
+    auto heuristic = [&](int node) {
+        sf::Vector2i t = tileOf(node);
+        return abs(t.x - goal.x) + abs(t.y - goal.y);
+    };
+
+    workspace.reset(goalNode + 1);
+    workspace.set(startNode, 0, startNode);
+
+    const greater<pair<int, int>> minHeap;
+    open.clear();
+    open.push_back({heuristic(startNode), startNode});
+
+    auto relax = [&](int from, int to, int cost) {
+        if (cost < workspace.costOf(to)) {
+            workspace.set(to, cost, from);
+            open.push_back({cost + heuristic(to), to});
+            push_heap(open.begin(), open.end(), minHeap);
+        }
+    };
+
+    bool found = false;
+    while (!open.empty()) {
+        pop_heap(open.begin(), open.end(), minHeap);
+        auto [priority, current] = open.back();
+        open.pop_back();
+
+        int currentCost = workspace.costOf(current);
+        if (priority - heuristic(current) > currentCost) continue;
+
+        nodesExplored++;
+
+        if (current == goalNode) {
+            found = true;
+            break;
+        }
+
+        if (current == startNode) {
+            for (size_t j = 0; j < sc.nodes.size(); ++j) {
+                if (startLinks[j] >= 0) relax(current, sc.nodes[j], startLinks[j]);
+            }
+            if (directCost >= 0) relax(current, goalNode, directCost);
+            continue;
+        }
+
+        const Node& node = nodes[current];
+        const Cluster& cluster = clusters[node.cluster];
+        int n = static_cast<int>(cluster.nodes.size());
+        for (int j = 0; j < n; ++j) {
+            int d = cluster.distances[node.slot * n + j];
+            if (j != node.slot && d >= 0) relax(current, cluster.nodes[j], currentCost + d);
+        }
+        relax(current, node.partner, currentCost + 1);
+        if (node.cluster == goalCluster && goalLinks[node.slot] >= 0) {
+            relax(current, goalNode, currentCost + goalLinks[node.slot]);
+        }
+    }
+
+    if (!found) return false;
+
+    route.length = workspace.costOf(goalNode);
+    for (int node = goalNode; node != startNode; node = workspace.parentOf(node)) {
+        sf::Vector2i tile = tileOf(node);
+        // Two entrances can share a corner tile
+        if (route.waypoints.empty() || route.waypoints.back() != tile) route.waypoints.push_back(tile);
+    }
+    if (route.waypoints.back() != start) route.waypoints.push_back(start);
+    reverse(route.waypoints.begin(), route.waypoints.end());
+
+    route.tiles.push_back(start);
+    return true;
+}
+
+bool HierarchicalPathfinder::refine(HpaRoute& route, int segments) {
+    for (int i = 0; i < segments && !route.isComplete(); ++i) {
+        sf::Vector2i from = route.waypoints[route.refinedSegments];
+        sf::Vector2i to = route.waypoints[route.refinedSegments + 1];
+        if (!refineSegment(from, to, route.tiles)) return false;
+        route.refinedSegments++;
+    }
+    return true;
+}
+
+// A* between two waypoints of the same cluster, kept inside that cluster
+bool HierarchicalPathfinder::refineSegment(sf::Vector2i from, sf::Vector2i to, vector<sf::Vector2i>& out) {
+    if (!grid.isWalkable(from) || !grid.isWalkable(to)) return false;
+    if (abs(from.x - to.x) + abs(from.y - to.y) == 1) {
+        out.push_back(to);
+        return true;
+    }
+
+    const Cluster& bounds = clusters[clusterOf(from.x, from.y)];
+    const int fromIndex = grid.index(from);
+    const int toIndex = grid.index(to);
+    const int dx[4] = {1, -1, 0, 0};
+    const int dy[4] = {0, 0, 1, -1};
+    auto heuristic = [&](int x, int y) { return abs(x - to.x) + abs(y - to.y); };
+
+    workspace.reset(grid.tileCount());
+    workspace.set(fromIndex, 0, fromIndex);
+
+    const greater<pair<int, int>> minHeap;
+    open.clear();
+    open.push_back({heuristic(from.x, from.y), fromIndex});
+
+    bool found = false;
+    while (!open.empty()) {
+        pop_heap(open.begin(), open.end(), minHeap);
+        auto [priority, current] = open.back();
+        open.pop_back();
+
+        int x = current % grid.width;
+        int y = current / grid.width;
+        int currentCost = workspace.costOf(current);
+        if (priority - heuristic(x, y) > currentCost) continue;
+
+        if (current == toIndex) {
+            found = true;
+            break;
+        }
+
+        for (int d = 0; d < 4; ++d) {
+            int nx = x + dx[d];
+            int ny = y + dy[d];
+            if (nx < bounds.left || nx > bounds.right || ny < bounds.top || ny > bounds.bottom) continue;
+            int next = ny * grid.width + nx;
+            if (!grid.walkable[next] || currentCost + 1 >= workspace.costOf(next)) continue;
+            workspace.set(next, currentCost + 1, current);
+            open.push_back({currentCost + 1 + heuristic(nx, ny), next});
+            push_heap(open.begin(), open.end(), minHeap);
+        }
+    }
+
+    if (!found) return false;
+
+    size_t segmentStart = out.size();
+    for (int tile = toIndex; tile != fromIndex; tile = workspace.parentOf(tile)) {
+        out.push_back(grid.tile(tile));
+    }
+    reverse(out.begin() + segmentStart, out.end());
+    return true;
+}
@@ -0,0 +1,103 @@
+#include "JumpTable.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+// Moving horizontally by dx into (x, y): does a vertical neighbour open up past a wall?
+bool hasForcedNeighbour(const SearchGrid& grid, int x, int y, int dx) {
+    return (grid.isWalkable(x, y - 1) && !grid.isWalkable(x - dx, y - 1)) ||
+           (grid.isWalkable(x, y + 1) && !grid.isWalkable(x - dx, y + 1));
+}
+
+// Distance for a tile given what lies one step ahead of it
+int16_t stepDistance(bool nextWalkable, bool nextIsJumpPoint, int16_t nextDistance) {
+    if (!nextWalkable) return 0;
+    if (nextIsJumpPoint) return 1;
+    return nextDistance > 0 ? nextDistance + 1 : nextDistance - 1;
+}
+
+} // namespace
+
+void JumpTable::build(const SearchGrid& grid) {
+    width = grid.width;
+    height = grid.height;
+    for (auto& d : distances) d.assign(grid.tileCount(), 0);
+    verticalStop.assign(grid.tileCount(), 0);
+
+    for (int y = 0; y < height; ++y) computeRow(grid, y);
+    for (int i = 0; i < grid.tileCount(); ++i) updateVerticalStop(i);
+    for (int x = 0; x < width; ++x) computeColumn(grid, x);
+}
+
+void JumpTable::computeRow(const SearchGrid& grid, int y) {
+    int row = y * width;
+
+    distances[EAST][row + width - 1] = 0;
+    for (int x = width - 2; x >= 0; --x) {
+        distances[EAST][row + x] = stepDistance(grid.walkable[row + x + 1],
+                                                hasForcedNeighbour(grid, x + 1, y, 1),
+                                                distances[EAST][row + x + 1]);
+    }
+
+    distances[WEST][row] = 0;
+    for (int x = 1; x < width; ++x) {
+        distances[WEST][row + x] = stepDistance(grid.walkable[row + x - 1],
+                                                hasForcedNeighbour(grid, x - 1, y, -1),
+                                                distances[WEST][row + x - 1]);
+    }
+}
+
+void JumpTable::computeColumn(const SearchGrid& grid, int x) {
+    distances[SOUTH][(height - 1) * width + x] = 0;
+    for (int y = height - 2; y >= 0; --y) {
+        int next = (y + 1) * width + x;
+        distances[SOUTH][y * width + x] = stepDistance(grid.walkable[next], verticalStop[next],
+                                                       distances[SOUTH][next]);
+    }
+
+    distances[NORTH][x] = 0;
+    for (int y = 1; y < height; ++y) {
+        int next = (y - 1) * width + x;
+        distances[NORTH][y * width + x] = stepDistance(grid.walkable[next], verticalStop[next],
+                                                       distances[NORTH][next]);
+    }
+}
+
+// Returns true if the flag flipped, meaning the vertical runs through this column change
+bool JumpTable::updateVerticalStop(int tile) {
+    unsigned char stop = distances[EAST][tile] > 0 || distances[WEST][tile] > 0;
+    if (verticalStop[tile] == stop) return false;
+    verticalStop[tile] = stop;
+    return true;
+}
+
+void JumpTable::update(const SearchGrid& grid, const vector<int>& changedTiles) {
+    if (!isBuilt() || grid.width != width || grid.height != height) {
+        build(grid);
+        return;
+    }
+
+    // A tile's walkability feeds the forced-neighbour test of the rows above and below it
+    vector<unsigned char> dirtyRow(height, 0);
+    vector<unsigned char> dirtyColumn(width, 0);
+    for (int tile : changedTiles) {
+        int x = tile % width;
+        int y = tile / width;
+        for (int r = max(0, y - 1); r <= min(height - 1, y + 1); ++r) dirtyRow[r] = 1;
+        dirtyColumn[x] = 1;
+    }
+
+    for (int y = 0; y < height; ++y) {
+        if (!dirtyRow[y]) continue;
+        computeRow(grid, y);
+        for (int x = 0; x < width; ++x) {
+            if (updateVerticalStop(y * width + x)) dirtyColumn[x] = 1;
+        }
+    }
+
+    for (int x = 0; x < width; ++x) {
+        if (dirtyColumn[x]) computeColumn(grid, x);
+    }
+}
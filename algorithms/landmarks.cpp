@@ -0,0 +1,123 @@
+#include "Landmarks.h"
+#include <algorithm>
+#include <chrono>
+
+using namespace std;
+
+namespace {
+
+// BFS distances from one tile, clamped below UNREACHABLE. Clamping only shrinks
+// differences, so estimates stay lower bounds even on very long maps.
+void distancesFrom(const SearchGrid& grid, int source, vector<int>& distance, vector<int>& queue) {
+    const int dx[4] = {1, -1, 0, 0};
+    const int dy[4] = {0, 0, 1, -1};
+    distance.assign(grid.tileCount(), -1);
+    queue.clear();
+    distance[source] = 0;
+    queue.push_back(source);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int current = queue[head];
+        int x = current % grid.width;
+        int y = current / grid.width;
+        for (int d = 0; d < 4; ++d) {
+            int nx = x + dx[d];
+            int ny = y + dy[d];
+            if (!grid.isWalkable(nx, ny)) continue;
+            int next = ny * grid.width + nx;
+            if (distance[next] >= 0) continue;
+            distance[next] = distance[current] + 1;
+            queue.push_back(next);
+        }
+    }
+}
+
+} // namespace
+
+shared_ptr<const LandmarkTable> LandmarkTable::build(const SearchGrid& grid, int count) {
+    auto table = make_shared<LandmarkTable>();
+    table->layout = grid.layout;
+    count = min(count, MAX_LANDMARKS);
+
+    // Start from the walkable tile nearest the middle of the map
+    int seed = -1;
+    int bestCentre = INT32_MAX;
+    for (int i = 0; i < grid.tileCount(); ++i) {
+        if (!grid.walkable[i]) continue;
+        sf::Vector2i t = grid.tile(i);
+        int centre = abs(t.x - grid.width / 2) + abs(t.y - grid.height / 2);
+        if (centre < bestCentre) {
+            bestCentre = centre;
+            seed = i;
+        }
+    }
+    if (seed < 0 || count <= 0) return table;
+
+    // Farthest-point selection: each landmark is the tile farthest from every landmark so
+    // far, which puts them on the edges of the map where they bound the most routes
+    vector<int> distance, queue;
+    vector<int> nearest(grid.tileCount(), INT32_MAX);
+    vector<vector<int>> columns;
+    distancesFrom(grid, seed, distance, queue);
+    for (int i = 0; i < grid.tileCount(); ++i) {
+        if (distance[i] >= 0) nearest[i] = distance[i];
+    }
+
+    for (int k = 0; k < count; ++k) {
+        int landmark = -1;
+        int farthest = -1;
+        for (int i = 0; i < grid.tileCount(); ++i) {
+            if (nearest[i] != INT32_MAX && nearest[i] > farthest) {
+                farthest = nearest[i];
+                landmark = i;
+            }
+        }
+        if (landmark < 0 || (k > 0 && farthest == 0)) break;
+
+        distancesFrom(grid, landmark, distance, queue);
+        for (int i = 0; i < grid.tileCount(); ++i) {
+            if (distance[i] >= 0) nearest[i] = min(nearest[i], distance[i]);
+        }
+        table->landmarks.push_back(grid.tile(landmark));
+        columns.push_back(distance);
+    }
+
+    table->count = static_cast<int>(columns.size());
+    table->distances.resize(static_cast<size_t>(grid.tileCount()) * table->count);
+    for (int k = 0; k < table->count; ++k) {
+        for (int i = 0; i < grid.tileCount(); ++i) {
+            int d = columns[k][i];
+            table->distances[static_cast<size_t>(i) * table->count + k] =
+                d < 0 ? UNREACHABLE : static_cast<uint16_t>(min(d, UNREACHABLE - 1));
+        }
+    }
+    return table;
+}
+
+void Landmarks::startBuild() {
+    auto snapshot = make_shared<const SearchGrid>(grid);
+    int landmarkCount = count;
+    building = async(launch::async, [snapshot, landmarkCount] {
+        return LandmarkTable::build(*snapshot, landmarkCount);
+    });
+}
+
+void Landmarks::sync(const Map& map) {
+    unsigned previousLayout = grid.layout;
+    grid.syncFrom(map);
+
+    if (grid.layout != previousLayout) {
+        table.reset();
+        if (isBuilding()) rebuildAgain = true;
+        else startBuild();
+    }
+
+    if (isBuilding() && building.wait_for(chrono::seconds(0)) == future_status::ready) {
+        auto built = building.get();
+        if (rebuildAgain) {
+            rebuildAgain = false;
+            startBuild();
+        } else if (built->layout == grid.layout) {
+            table = built;
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#include "LavaForecast.h"
+#include <limits>
+
+using namespace std;
+
+// Relaxes outward from queue[head...], lowering counts only where they drop. Every
+// queued tile starts at 0, so this is plain BFS order and no tile is queued twice.
+void LavaForecast::spreadFrom(size_t head) {
+    const int dx[4] = {1, -1, 0, 0};
+    const int dy[4] = {0, 0, 1, -1};
+    for (; head < queue.size(); ++head) {
+        int tile = queue[head];
+        int x = tile % grid.width;
+        int y = tile / grid.width;
+        int next = ticks[tile] + 1;
+        for (int d = 0; d < 4; ++d) {
+            if (!grid.isWalkable(x + dx[d], y + dy[d])) continue;
+            int neighbour = grid.index(x + dx[d], y + dy[d]);
+            if (ticks[neighbour] <= next) continue;
+            ticks[neighbour] = next;
+            queue.push_back(neighbour);
+            tilesUpdated++;
+        }
+    }
+}
+
+// Lava left by the generator never spreads, so only the spreading lava seeds the search
+void LavaForecast::build(const Map& map) {
+    ticks.assign(grid.tileCount(), NEVER);
+    queue.clear();
+    for (int i = 0; i < grid.tileCount(); ++i) {
+        if (!grid.walkable[i]) ticks[i] = 0;
+    }
+    for (const auto& tile : map.getLavaTiles()) {
+        if (grid.inBounds(tile.x, tile.y)) queue.push_back(grid.index(tile));
+    }
+    tilesUpdated = grid.tileCount();
+    spreadFrom(0);
+}
+
+void LavaForecast::sync(const Map& map) {
+    tick = map.getLavaTick();
+    secondsToNextTick = Map::lavaSpreadInterval - map.getLavaTimer();
+    tilesUpdated = 0;
+
+    GridChange change = grid.syncFrom(map);
+    if (change == GridChange::Rebuilt) {
+        build(map);
+    } else if (change == GridChange::Patched) {
+        // Counts are from the lava as it is now, so a tick that closed tiles only lowers them
+        queue.clear();
+        for (int tile : grid.changedTiles) {
+            ticks[tile] = 0;
+            queue.push_back(tile);
+        }
+        tilesUpdated = static_cast<int>(queue.size());
+        spreadFrom(0);
+    }
+}
+
+float LavaForecast::secondsUntilLava(int x, int y) const {
+    int count = ticksUntilLava(x, y);
+    if (count == 0) return 0.f;
+    if (count == NEVER) return numeric_limits<float>::max();
+    return secondsToNextTick + (count - 1) * Map::lavaSpreadInterval;
+}
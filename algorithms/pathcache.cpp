@@ -0,0 +1,118 @@
+#include "PathCache.h"
+#include <algorithm>
+#include <sstream>
+
+using namespace std;
+
+void PathCache::sync(const Map& map) {
+    if (grid.version == map.getVersion()) return;
+
+    unsigned previousLayout = grid.layout;
+    previousWalkable = grid.walkable;
+    GridChange change = grid.syncFrom(map);
+
+    if (change == GridChange::Patched) {
+        for (int tile : grid.changedTiles) invalidateTile(tile);
+    } else if (change == GridChange::Rebuilt) {
+        if (grid.layout != previousLayout || previousWalkable.size() != grid.walkable.size()) {
+            clear();
+            entriesOnTile.assign(grid.tileCount(), {});
+            return;
+        }
+        // Missed ticks on the same layout: the tiles that closed are the ones to check
+        for (int i = 0; i < grid.tileCount(); ++i) {
+            if (previousWalkable[i] && !grid.walkable[i]) invalidateTile(i);
+        }
+    }
+}
+
+void PathCache::invalidateTile(int tile) {
+    for (const auto& [key, id] : entriesOnTile[tile]) {
+        auto it = entries.find(key);
+        if (it != entries.end() && it->second.id == id) {
+            entries.erase(it);
+            invalidations++;
+        }
+    }
+    indexed -= entriesOnTile[tile].size();
+    entriesOnTile[tile].clear();
+}
+
+// Evicted and replaced entries leave references behind; drop them once they pile up
+void PathCache::rebuildIndex() {
+    for (auto& list : entriesOnTile) list.clear();
+    indexed = 0;
+    for (const auto& [key, entry] : entries) {
+        for (const auto& tile : entry.value.path) entriesOnTile[grid.index(tile)].push_back({key, entry.id});
+        indexed += entry.value.path.size();
+    }
+    indexLimit = max(static_cast<size_t>(grid.tileCount()) * 4, indexed * 2);
+}
+
+// Doesn't count; find and findPair count each lookup once
+CachedPath* PathCache::lookup(sf::Vector2i start, sf::Vector2i goal, PathQuery query) {
+    if (!grid.isWalkable(start) || !grid.isWalkable(goal)) return nullptr;
+    auto it = entries.find(keyOf(start, goal, query));
+    if (it == entries.end()) return nullptr;
+    it->second.lastUsed = ++useClock;
+    return &it->second.value;
+}
+
+const CachedPath* PathCache::find(sf::Vector2i start, sf::Vector2i goal, PathQuery query) {
+    const CachedPath* found = lookup(start, goal, query);
+    if (found) hits++;
+    else misses++;
+    return found;
+}
+
+void PathCache::findPair(sf::Vector2i start, sf::Vector2i goal, PathQuery first, PathQuery second,
+                         const CachedPath*& firstPath, const CachedPath*& secondPath) {
+    firstPath = lookup(start, goal, first);
+    secondPath = firstPath ? lookup(start, goal, second) : nullptr;
+    if (firstPath && secondPath && !firstPath->path.empty() && !secondPath->path.empty()) {
+        hits++;
+        return;
+    }
+    misses++;
+    firstPath = secondPath = nullptr;
+}
+
+void PathCache::store(sf::Vector2i start, sf::Vector2i goal, PathQuery query, unsigned layout,
+                      const vector<sf::Vector2i>& path, int nodesExplored) {
+    if (layout != grid.layout || !grid.inBounds(start.x, start.y) || !grid.inBounds(goal.x, goal.y)) return;
+    for (const auto& tile : path) {
+        if (!grid.isWalkable(tile)) return; // lava reached it while it was being searched
+    }
+
+    // Full: evict the least recently used entry
+    Key key = keyOf(start, goal, query);
+    if (entries.size() >= capacity && entries.find(key) == entries.end()) {
+        auto oldest = entries.begin();
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if (it->second.lastUsed < oldest->second.lastUsed) oldest = it;
+        }
+        entries.erase(oldest);
+    }
+
+    Entry& entry = entries[key];
+    entry.value.path = path;
+    entry.value.nodesExplored = nodesExplored;
+    entry.id = ++nextId;
+    entry.lastUsed = ++useClock;
+    for (const auto& tile : path) entriesOnTile[grid.index(tile)].push_back({key, entry.id});
+    indexed += path.size();
+    if (indexed > max(indexLimit, static_cast<size_t>(grid.tileCount()) * 4)) rebuildIndex();
+}
+
+void PathCache::clear() {
+    entries.clear();
+    for (auto& list : entriesOnTile) list.clear();
+    indexed = 0;
+}
+
+string PathCache::report() const {
+    stringstream ss;
+    ss << "cache: " << hits << " hits / " << misses << " misses (" << static_cast<int>(hitRate() * 100 + 0.5f)
+       << "%), " << invalidations << " invalidated";
+    return ss.str();
+}
@@ -0,0 +1,370 @@
+#include "Pathfinder.h"
+#include <algorithm>
+#include <functional>
+#include <cstdlib>
+#include <climits>
+#include <chrono>
+
+using namespace std;
+
+void Pathfinder::sync(const Map& map) {
+    GridChange change = grid.syncFrom(map);
+    if (change == GridChange::Rebuilt) {
+        jumpTableStale = true;
+    } else if (change == GridChange::Patched && !jumpTableStale) {
+        jumpTable.update(grid, grid.changedTiles);
+    }
+}
+
+vector<sf::Vector2i> Pathfinder::findDijkstraPath(const Map& map, sf::Vector2i start, sf::Vector2i goal) {
+    sync(map);
+    return search(grid, start, goal, false);
+}
+
+vector<sf::Vector2i> Pathfinder::findAStarPath(const Map& map, sf::Vector2i start, sf::Vector2i goal) {
+    sync(map);
+    return search(grid, start, goal, true);
+}
+
+vector<sf::Vector2i> Pathfinder::findDijkstraPath(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal) {
+    return search(searchGrid, start, goal, false);
+}
+
+vector<sf::Vector2i> Pathfinder::findAStarPath(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal) {
+    return search(searchGrid, start, goal, true);
+}
+
+vector<sf::Vector2i> Pathfinder::findAStarPath(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal,
+                                              const LandmarkTable& landmarks) {
+    return search(searchGrid, start, goal, true, &landmarks);
+}
+
+vector<sf::Vector2i> Pathfinder::findBidirectionalDijkstraPath(const Map& map, sf::Vector2i start, sf::Vector2i goal) {
+    sync(map);
+    return searchBidirectional(grid, start, goal, false);
+}
+
+vector<sf::Vector2i> Pathfinder::findBidirectionalAStarPath(const Map& map, sf::Vector2i start, sf::Vector2i goal) {
+    sync(map);
+    return searchBidirectional(grid, start, goal, true);
+}
+
+vector<sf::Vector2i> Pathfinder::findBidirectionalDijkstraPath(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal) {
+    return searchBidirectional(searchGrid, start, goal, false);
+}
+
+vector<sf::Vector2i> Pathfinder::findBidirectionalAStarPath(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal) {
+    return searchBidirectional(searchGrid, start, goal, true);
+}
+
+vector<sf::Vector2i> Pathfinder::findJPSPath(const Map& map, sf::Vector2i start, sf::Vector2i goal) {
+    sync(map);
+    return searchJPS(grid, start, goal, false);
+}
+
+vector<sf::Vector2i> Pathfinder::findJPSPath(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal) {
+    return searchJPS(searchGrid, start, goal, false);
+}
+
+vector<sf::Vector2i> Pathfinder::findJPSPlusPath(const Map& map, sf::Vector2i start, sf::Vector2i goal) {
+    sync(map);
+    if (jumpTableStale) {
+        jumpTable.build(grid);
+        jumpTableStale = false;
+    }
+    return searchJPS(grid, start, goal, true);
+}
+
+vector<sf::Vector2i> Pathfinder::search(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal, bool useHeuristic,
+                                        const LandmarkTable* landmarks) {
+    if (!beginQuery(searchGrid, start, goal)) return endQuery({});
+
+    const int startIndex = searchGrid.index(start);
+    const int goalIndex = searchGrid.index(goal);
+    auto stop = [this] { return shouldStop(); };
+    bool found;
+
+    // Buckets rely on Manhattan changing by exactly 1 per step, which ALT doesn't
+    const bool useLandmarks = useHeuristic && landmarks && landmarks->matches(searchGrid);
+    if (useLandmarks) {
+        LandmarkHeuristic heuristic{goal, landmarks, landmarks->at(goalIndex), searchGrid.width};
+        found = runSearch<FourNeighbours>(searchGrid, startIndex, goalIndex, heuristic, heapOpen, workspace, stats, stop);
+    } else if (unitCostEngine) {
+        // Unit steps need no heap: Dijkstra becomes a BFS over a FIFO, and A* needs only the
+        // f and f + 2 buckets
+        if (useHeuristic) {
+            found = runSearch<FourNeighbours>(searchGrid, startIndex, goalIndex, ManhattanHeuristic{goal}, bucketOpen, workspace, stats, stop);
+        } else {
+            found = runSearch<FourNeighbours>(searchGrid, startIndex, goalIndex, NoHeuristic{}, fifoOpen, workspace, stats, stop);
+        }
+    } else if (useHeuristic) {
+        found = runSearch<FourNeighbours>(searchGrid, startIndex, goalIndex, ManhattanHeuristic{goal}, heapOpen, workspace, stats, stop);
+    } else {
+        found = runSearch<FourNeighbours>(searchGrid, startIndex, goalIndex, NoHeuristic{}, heapOpen, workspace, stats, stop);
+    }
+
+    if (!found || stopped) return endQuery({});
+    return endQuery(buildPath(searchGrid, startIndex, goalIndex));
+}
+
+// Forward search from the start and backward search from the goal, always expanding the
+// side with the smaller open list. best is the shortest start-goal connection seen so far.
+// Dijkstra may stop once the two smallest costs add up to best; A* (each side aiming at
+// the other end) may stop once either side's smallest f reaches best.
+vector<sf::Vector2i> Pathfinder::searchBidirectional(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal, bool useHeuristic) {
+    if (!beginQuery(searchGrid, start, goal)) return endQuery({});
+
+    const int width = searchGrid.width;
+    const int startIndex = searchGrid.index(start);
+    const int goalIndex = searchGrid.index(goal);
+    const int dx[4] = {1, -1, 0, 0};
+    const int dy[4] = {0, 0, 1, -1};
+    const greater<pair<int, int>> minHeap;
+
+    struct Side {
+        SearchWorkspace& state;
+        vector<pair<int, int>>& heap;
+        sf::Vector2i target;
+    };
+    Side sides[2] = {{workspace, open, goal}, {backwardWorkspace, backwardOpen, start}};
+
+    auto heuristic = [&](const Side& side, int x, int y) {
+        return useHeuristic ? abs(x - side.target.x) + abs(y - side.target.y) : 0;
+    };
+
+    workspace.reset(searchGrid.tileCount());
+    backwardWorkspace.reset(searchGrid.tileCount());
+    workspace.set(startIndex, 0, startIndex);
+    backwardWorkspace.set(goalIndex, 0, goalIndex);
+    open.clear();
+    backwardOpen.clear();
+    open.push_back({heuristic(sides[0], start.x, start.y), startIndex});
+    backwardOpen.push_back({heuristic(sides[1], goal.x, goal.y), goalIndex});
+    stats.onPush(1);
+    stats.onPush(2);
+
+    int best = startIndex == goalIndex ? 0 : INT_MAX;
+    int meet = startIndex == goalIndex ? startIndex : -1;
+
+    while (!open.empty() && !backwardOpen.empty()) {
+        int forwardTop = open.front().first;
+        int backwardTop = backwardOpen.front().first;
+        if (best != INT_MAX) {
+            if (useHeuristic ? max(forwardTop, backwardTop) >= best : forwardTop + backwardTop >= best) break;
+        }
+
+        Side& side = open.size() <= backwardOpen.size() ? sides[0] : sides[1];
+        SearchWorkspace& other = &side == &sides[0] ? backwardWorkspace : workspace;
+
+        pop_heap(side.heap.begin(), side.heap.end(), minHeap);
+        auto [priority, current] = side.heap.back();
+        side.heap.pop_back();
+
+        int x = current % width;
+        int y = current / width;
+        int currentCost = side.state.costOf(current);
+        if (priority - heuristic(side, x, y) > currentCost) {
+            stats.onStalePop();
+            continue;
+        }
+
+        stats.onExpand();
+        if (shouldStop()) break;
+
+        for (int d = 0; d < 4; ++d) {
+            int nx = x + dx[d];
+            int ny = y + dy[d];
+            if (!searchGrid.isWalkable(nx, ny)) continue;
+
+            int next = ny * width + nx;
+            int newCost = currentCost + 1;
+            if (newCost >= side.state.costOf(next)) continue;
+
+            side.state.set(next, newCost, current);
+            side.heap.push_back({newCost + heuristic(side, nx, ny), next});
+            push_heap(side.heap.begin(), side.heap.end(), minHeap);
+            stats.onPush(open.size() + backwardOpen.size());
+
+            if (other.visited(next) && newCost + other.costOf(next) < best) {
+                best = newCost + other.costOf(next);
+                meet = next;
+            }
+        }
+    }
+
+    if (meet < 0 || stopped) return endQuery({});
+
+    // Forward half from the start to the meeting tile, then the backward half on to the goal
+    vector<sf::Vector2i> path;
+    for (int tile = meet; tile != startIndex; tile = workspace.parentOf(tile)) {
+        path.push_back(searchGrid.tile(tile));
+    }
+    path.push_back(start);
+    reverse(path.begin(), path.end());
+    for (int tile = meet; tile != goalIndex; ) {
+        tile = backwardWorkspace.parentOf(tile);
+        path.push_back(searchGrid.tile(tile));
+    }
+    return endQuery(move(path));
+}
+
+// Walk the parent links back from the goal. Consecutive nodes may be jump points in a
+// straight line, so the tiles between them are filled in.
+vector<sf::Vector2i> Pathfinder::buildPath(const SearchGrid& searchGrid, int startIndex, int goalIndex) const {
+    vector<sf::Vector2i> path;
+    for (int current = goalIndex; current != startIndex; current = workspace.parentOf(current)) {
+        sf::Vector2i tile = searchGrid.tile(current);
+        sf::Vector2i from = searchGrid.tile(workspace.parentOf(current));
+        sf::Vector2i step((from.x > tile.x) - (from.x < tile.x), (from.y > tile.y) - (from.y < tile.y));
+        for (; tile != from; tile += step) path.push_back(tile);
+    }
+    path.push_back(searchGrid.tile(startIndex));
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+bool Pathfinder::beginQuery(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal) {
+    stats = SearchStats();
+    stopped = false;
+    queryBegin = chrono::steady_clock::now();
+    if (!searchGrid.isWalkable(start)) stats.failure = SearchFailure::StartBlocked;
+    else if (!searchGrid.isWalkable(goal)) stats.failure = SearchFailure::GoalBlocked;
+    return stats.failure == SearchFailure::None;
+}
+
+vector<sf::Vector2i> Pathfinder::endQuery(vector<sf::Vector2i> path) {
+    if (path.empty() && stats.failure == SearchFailure::None) {
+        stats.failure = stopped ? SearchFailure::Stopped : SearchFailure::Unreachable;
+    }
+    stats.wallMs = chrono::duration<double, milli>(chrono::steady_clock::now() - queryBegin).count();
+    return path;
+}
+
+namespace {
+
+// Step from (x, y) in direction (dx, dy) until reaching a jump point, the goal, or a wall.
+// On a 4-connected grid a horizontal run stops where a vertical neighbour opens up behind
+// a wall (a forced neighbour); a vertical run stops wherever a horizontal run would stop.
+int jump(const SearchGrid& grid, int x, int y, int dx, int dy, sf::Vector2i goal) {
+    while (true) {
+        x += dx;
+        y += dy;
+        if (!grid.isWalkable(x, y)) return -1;
+        if (x == goal.x && y == goal.y) return grid.index(x, y);
+
+        if (dx != 0) {
+            if ((grid.isWalkable(x, y - 1) && !grid.isWalkable(x - dx, y - 1)) ||
+                (grid.isWalkable(x, y + 1) && !grid.isWalkable(x - dx, y + 1))) {
+                return grid.index(x, y);
+            }
+        } else if (jump(grid, x, y, 1, 0, goal) != -1 || jump(grid, x, y, -1, 0, goal) != -1) {
+            return grid.index(x, y);
+        }
+    }
+}
+
+// Same jump as above, answered from the JPS+ table. The table knows nothing about the goal,
+// so a run that passes the goal (or the goal's row, when moving vertically) stops there.
+int jumpPrecomputed(const JumpTable& table, const SearchGrid& grid, int x, int y, int dx, int dy, sf::Vector2i goal) {
+    JumpTable::Direction dir = dx > 0 ? JumpTable::EAST : dx < 0 ? JumpTable::WEST
+                             : dy > 0 ? JumpTable::SOUTH : JumpTable::NORTH;
+    int distance = table.distance(grid.index(x, y), dir);
+    int reach = distance > 0 ? distance : -distance;
+
+    if (dx != 0) {
+        int toGoal = (goal.x - x) * dx;
+        if (goal.y == y && toGoal > 0 && toGoal <= reach) return grid.index(goal);
+    } else {
+        int toGoalRow = (goal.y - y) * dy;
+        if (toGoalRow > 0 && toGoalRow <= reach) return grid.index(x, goal.y);
+    }
+
+    return distance > 0 ? grid.index(x + dx * distance, y + dy * distance) : -1;
+}
+
+} // namespace
+
+vector<sf::Vector2i> Pathfinder::searchJPS(const SearchGrid& searchGrid, sf::Vector2i start, sf::Vector2i goal, bool precomputed) {
+    if (!beginQuery(searchGrid, start, goal)) return endQuery({});
+
+    const int width = searchGrid.width;
+    const int startIndex = searchGrid.index(start);
+    const int goalIndex = searchGrid.index(goal);
+
+    auto heuristic = [&](int x, int y) { return abs(x - goal.x) + abs(y - goal.y); };
+
+    workspace.reset(searchGrid.tileCount());
+    workspace.set(startIndex, 0, startIndex);
+
+    const greater<pair<int, int>> minHeap;
+    open.clear();
+    open.push_back({heuristic(start.x, start.y), startIndex});
+    stats.onPush(open.size());
+
+    bool pathFound = false;
+
+    while (!open.empty()) {
+        pop_heap(open.begin(), open.end(), minHeap);
+        auto [priority, current] = open.back();
+        open.pop_back();
+
+        int x = current % width;
+        int y = current / width;
+        int currentCost = workspace.costOf(current);
+
+        if (priority - heuristic(x, y) > currentCost) {
+            stats.onStalePop();
+            continue;
+        }
+
+        stats.onExpand();
+        if (shouldStop()) break;
+
+        if (current == goalIndex) {
+            pathFound = true;
+            break;
+        }
+
+        // Only the neighbours an optimal path could continue to are kept (pruned neighbours)
+        sf::Vector2i directions[4];
+        int count = 0;
+        if (current == startIndex) {
+            directions[count++] = {1, 0};
+            directions[count++] = {-1, 0};
+            directions[count++] = {0, 1};
+            directions[count++] = {0, -1};
+        } else {
+            sf::Vector2i parent = searchGrid.tile(workspace.parentOf(current));
+            int dx = (x > parent.x) - (x < parent.x);
+            int dy = (y > parent.y) - (y < parent.y);
+            directions[count++] = {dx, dy};
+            if (dx != 0) {
+                if (searchGrid.isWalkable(x, y - 1) && !searchGrid.isWalkable(x - dx, y - 1)) directions[count++] = {0, -1};
+                if (searchGrid.isWalkable(x, y + 1) && !searchGrid.isWalkable(x - dx, y + 1)) directions[count++] = {0, 1};
+            } else {
+                directions[count++] = {1, 0};
+                directions[count++] = {-1, 0};
+            }
+        }
+
+        for (int d = 0; d < count; ++d) {
+            int next = precomputed
+                ? jumpPrecomputed(jumpTable, searchGrid, x, y, directions[d].x, directions[d].y, goal)
+                : jump(searchGrid, x, y, directions[d].x, directions[d].y, goal);
+            if (next == -1) continue;
+
+            sf::Vector2i nextTile = searchGrid.tile(next);
+            int newCost = currentCost + abs(nextTile.x - x) + abs(nextTile.y - y);
+
+            if (newCost < workspace.costOf(next)) {
+                workspace.set(next, newCost, current);
+                open.push_back({newCost + heuristic(nextTile.x, nextTile.y), next});
+                push_heap(open.begin(), open.end(), minHeap);
+                stats.onPush(open.size());
+            }
+        }
+    }
+
+    if (!pathFound) return endQuery({});
+    return endQuery(buildPath(searchGrid, startIndex, goalIndex));
+}
@@ -0,0 +1,112 @@
+#include "PathService.h"
+#include "Pathfinder.h"
+
+using namespace std;
+
+PathService::PathService() : worker(&PathService::run, this) {}
+
+PathService::~PathService() {
+    {
+        lock_guard<mutex> lock(requestMutex);
+        stopping = true;
+        for (auto& [handle, cancelled] : pending) *cancelled = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+unsigned PathService::submit(PathQuery query, const SearchGrid& grid, sf::Vector2i start, sf::Vector2i goal,
+                             chrono::milliseconds timeout, shared_ptr<const LandmarkTable> landmarks) {
+    // Queries between two lava ticks share one copy of the grid
+    if (!snapshot || snapshot->version != grid.version) {
+        snapshot = make_shared<const SearchGrid>(grid);
+    }
+
+    unsigned handle = nextHandle++;
+    if (nextHandle == 0) nextHandle = 1;
+    Request request{handle, query, start, goal, snapshot, move(landmarks),
+                    chrono::steady_clock::now() + timeout, make_shared<atomic<bool>>(false)};
+    {
+        lock_guard<mutex> lock(requestMutex);
+        pending[request.handle] = request.cancelled;
+        requests.push_back(move(request));
+    }
+    wake.notify_one();
+    return handle;
+}
+
+void PathService::cancel(unsigned handle) {
+    lock_guard<mutex> lock(requestMutex);
+    auto it = pending.find(handle);
+    if (it != pending.end()) *it->second = true;
+}
+
+void PathService::cancelAll() {
+    lock_guard<mutex> lock(requestMutex);
+    for (auto& [handle, cancelled] : pending) *cancelled = true;
+}
+
+void PathService::run() {
+    Pathfinder pathfinder; // the worker's own workspace, reused for every query
+
+    while (true) {
+        Request request;
+        {
+            unique_lock<mutex> lock(requestMutex);
+            wake.wait(lock, [this] { return stopping || !requests.empty(); });
+            if (stopping) return;
+            request = move(requests.front());
+            requests.pop_front();
+        }
+
+        bool timedOut = false;
+        pathfinder.setStopCheck([&] {
+            if (*request.cancelled) return true;
+            timedOut = chrono::steady_clock::now() > request.deadline;
+            return timedOut;
+        });
+
+        PathResult result;
+        result.handle = request.handle;
+        result.query = request.query;
+        result.start = request.start;
+        result.goal = request.goal;
+        result.layout = request.grid->layout;
+
+        if (!*request.cancelled) {
+            const SearchGrid& grid = *request.grid;
+            switch (request.query) {
+                case PathQuery::Dijkstra: result.path = pathfinder.findDijkstraPath(grid, request.start, request.goal); break;
+                case PathQuery::AStar: result.path = pathfinder.findAStarPath(grid, request.start, request.goal); break;
+                case PathQuery::BidirectionalDijkstra: result.path = pathfinder.findBidirectionalDijkstraPath(grid, request.start, request.goal); break;
+                case PathQuery::BidirectionalAStar: result.path = pathfinder.findBidirectionalAStarPath(grid, request.start, request.goal); break;
+                case PathQuery::JPS: result.path = pathfinder.findJPSPath(grid, request.start, request.goal); break;
+                case PathQuery::ALT:
+                    result.path = request.landmarks ? pathfinder.findAStarPath(grid, request.start, request.goal, *request.landmarks)
+                                                    : pathfinder.findAStarPath(grid, request.start, request.goal);
+                    break;
+            }
+            result.stats = pathfinder.getLastStats();
+        } else {
+            result.stats.failure = SearchFailure::Stopped;
+        }
+
+        if (*request.cancelled) result.status = PathStatus::Cancelled;
+        else if (pathfinder.wasStopped()) result.status = timedOut ? PathStatus::TimedOut : PathStatus::Cancelled;
+        else result.status = result.path.empty() ? PathStatus::NoPath : PathStatus::Found;
+
+        {
+            lock_guard<mutex> lock(requestMutex);
+            pending.erase(request.handle);
+        }
+
+        // The main loop drains every frame, so a full queue only waits a frame
+        while (!results.push(move(result))) {
+            {
+                lock_guard<mutex> lock(requestMutex);
+                if (stopping) return;
+            }
+            this_thread::yield();
+        }
+    }
+}
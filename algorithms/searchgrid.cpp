@@ -0,0 +1,33 @@
+#include "SearchGrid.h"
+#include "../UI-UX/Map.h"
+
+GridChange SearchGrid::syncFrom(const Map& map) {
+    bool sameSize = width == map.getWidth() && height == map.getHeight();
+    if (version == map.getVersion() && sameSize)
+        return GridChange::None;
+
+    changedTiles.clear();
+
+    // Exactly one spread tick behind: flip only the tiles that tick touched
+    if (sameSize && version + 1 == map.getVersion() && map.wasLastChangeSpread()) {
+        for (const auto& tile : map.getLastLavaChanges()) {
+            if (!inBounds(tile.x, tile.y)) continue;
+            walkable[index(tile)] = 0;
+            changedTiles.push_back(index(tile));
+        }
+        version = map.getVersion();
+        return GridChange::Patched;
+    }
+
+    width = map.getWidth();
+    height = map.getHeight();
+    version = map.getVersion();
+    layout = map.getLayout();
+
+    const std::vector<unsigned char>& lava = map.getLavaGrid();
+    walkable.assign(static_cast<size_t>(width) * height, 1);
+    if (lava.size() == walkable.size()) {
+        for (size_t i = 0; i < lava.size(); ++i) walkable[i] = lava[i] ? 0 : 1;
+    }
+    return GridChange::Rebuilt;
+}
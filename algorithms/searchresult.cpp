@@ -0,0 +1,41 @@
+#include "SearchResult.h"
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+namespace {
+function<void(const string&)> searchLog;
+}
+
+string failureText(SearchFailure failure) {
+    switch (failure) {
+        case SearchFailure::None: return "path found";
+        case SearchFailure::StartBlocked: return "start is blocked";
+        case SearchFailure::GoalBlocked: return "destination is blocked";
+        case SearchFailure::Unreachable: return "destination is unreachable";
+        case SearchFailure::Stopped: return "search was stopped";
+        case SearchFailure::Outdated: return "lava has spread over the precomputed path";
+    }
+    return "";
+}
+
+string describeSearch(const SearchStats& stats) {
+    stringstream ss;
+    ss << stats.expanded << " expanded, " << stats.pushed << " pushed\n"
+       << stats.stalePops << " stale pops, peak open " << stats.peakOpen << "\n"
+       << fixed << setprecision(2) << stats.wallMs << " ms";
+    return ss.str();
+}
+
+void setSearchLog(function<void(const string&)> sink) {
+    searchLog = move(sink);
+}
+
+void logSearch(const string& line) {
+    if (searchLog) searchLog(line);
+}
+
+bool searchLogEnabled() {
+    return static_cast<bool>(searchLog);
+}
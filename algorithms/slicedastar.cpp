@@ -0,0 +1,84 @@
+#include "SlicedAStar.h"
+
+using namespace std;
+
+bool SlicedAStar::begin(const Map& map, sf::Vector2i from, sf::Vector2i destination) {
+    grid.syncFrom(map);
+    start = from;
+    goal = destination;
+    stats = SearchStats();
+    slices = 0;
+    path.clear();
+    searching = false;
+
+    if (!grid.isWalkable(start) || !grid.isWalkable(goal)) {
+        stats.failure = grid.isWalkable(start) ? SearchFailure::GoalBlocked : SearchFailure::StartBlocked;
+        return false;
+    }
+    startIndex = grid.index(start);
+    goalIndex = grid.index(goal);
+    startEstimate = abs(start.x - goal.x) + abs(start.y - goal.y);
+    state.width = grid.width;
+    state.goal = goal;
+    beginSearch(grid, startIndex, ManhattanHeuristic{goal}, open, state, stats);
+    searching = true;
+    return true;
+}
+
+bool SlicedAStar::step(chrono::microseconds budget) {
+    if (!searching) return false;
+
+    auto began = chrono::steady_clock::now();
+    auto deadline = began + budget;
+    int pops = 0;
+    auto outOfTime = [&] {
+        // Reading the clock costs about as much as an expansion, so only do it now and then
+        return ++pops % 128 == 0 && chrono::steady_clock::now() >= deadline;
+    };
+    bool found = resumeSearch<FourNeighbours>(grid, goalIndex, ManhattanHeuristic{goal}, open, state, stats, outOfTime);
+    slices++;
+    stats.wallMs += chrono::duration<double, milli>(chrono::steady_clock::now() - began).count();
+
+    if (found) {
+        path = tracePath(grid, state, startIndex, goalIndex);
+    } else if (open.empty()) {
+        stats.failure = SearchFailure::Unreachable;
+    } else {
+        return false;
+    }
+    searching = false;
+    return true;
+}
+
+bool SlicedAStar::sync(const Map& map, sf::Vector2i from) {
+    if (!searching) return false;
+
+    GridChange change = grid.syncFrom(map);
+    if (change == GridChange::None) return false;
+
+    // Lava only closes tiles: one nothing has reached yet is skipped when it's expanded to
+    bool hit = change == GridChange::Rebuilt;
+    for (int tile : grid.changedTiles) {
+        if (state.visited(tile)) hit = true;
+    }
+    if (!hit) return false;
+
+    int slicesSoFar = slices;
+    double msSoFar = stats.wallMs;
+    if (begin(map, from, goal)) {
+        slices = slicesSoFar;
+        stats.wallMs = msSoFar;
+    }
+    return true;
+}
+
+float SlicedAStar::getProgress() const {
+    if (!searching) return path.empty() ? 0.f : 1.f;
+    if (startEstimate == 0) return 1.f;
+    return 1.f - static_cast<float>(state.nearestEstimate) / startEstimate;
+}
+
+vector<sf::Vector2i> SlicedAStar::getProbe() const {
+    if (!searching) return path;
+    return tracePath(grid, state, startIndex, state.nearest);
+}
@@ -0,0 +1,83 @@
+#include "SpaceTimeAStar.h"
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+SearchResult SpaceTimeAStar::findPath(const LavaForecast& forecast, sf::Vector2i start, sf::Vector2i goal,
+                                      chrono::microseconds budget) {
+    const SearchGrid& grid = forecast.getGrid();
+    auto began = chrono::steady_clock::now();
+    auto deadline = budget == chrono::microseconds::max() ? chrono::steady_clock::time_point::max() : began + budget;
+    SearchResult result;
+    SearchStats& stats = result.stats;
+    lavaPruned = 0;
+    slackSeconds = 0.f;
+
+    auto finish = [&](SearchFailure failure) {
+        stats.failure = failure;
+        stats.wallMs = chrono::duration<double, milli>(chrono::steady_clock::now() - began).count();
+        return result;
+    };
+    if (!grid.isWalkable(start)) return finish(SearchFailure::StartBlocked);
+    if (!grid.isWalkable(goal)) return finish(SearchFailure::GoalBlocked);
+
+    // A tile entered on step k is left on step k + 1; lava must not be able to get there first
+    auto staysAhead = [&](int x, int y, int arrivalStep) {
+        return (arrivalStep + 1) * secondsPerStep + marginSeconds < forecast.secondsUntilLava(x, y);
+    };
+
+    const int dx[4] = {1, -1, 0, 0};
+    const int dy[4] = {0, 0, 1, -1};
+    const int startIndex = grid.index(start);
+    const int goalIndex = grid.index(goal);
+    ManhattanHeuristic heuristic{goal};
+    beginSearch(grid, startIndex, heuristic, open, workspace, stats);
+
+    bool found = false;
+    int sinceClockCheck = 0;
+    while (!open.empty()) {
+        auto [priority, current] = open.pop();
+        int x = current % grid.width;
+        int y = current / grid.width;
+        int steps = workspace.costOf(current);
+        if (priority - heuristic(x, y) > steps) {
+            // An earlier arrival at this tile was found since; it dominates this one
+            stats.onStalePop();
+            continue;
+        }
+        stats.onExpand();
+        if (current == goalIndex) {
+            found = true;
+            break;
+        }
+        if (++sinceClockCheck == 256) {
+            sinceClockCheck = 0;
+            if (chrono::steady_clock::now() >= deadline) return finish(SearchFailure::Stopped);
+        }
+
+        for (int d = 0; d < 4; ++d) {
+            int nx = x + dx[d];
+            int ny = y + dy[d];
+            if (!grid.isWalkable(nx, ny)) continue;
+            int next = grid.index(nx, ny);
+            if (steps + 1 >= workspace.costOf(next)) continue;
+            if (!staysAhead(nx, ny, steps + 1)) {
+                lavaPruned++;
+                continue;
+            }
+            workspace.set(next, steps + 1, current);
+            open.push(steps + 1 + heuristic(nx, ny), next);
+            stats.onPush(open.size());
+        }
+    }
+    if (!found) return finish(SearchFailure::Unreachable);
+
+    result.path = tracePath(grid, workspace, startIndex, goalIndex);
+    slackSeconds = forecast.secondsUntilLava(start.x, start.y);
+    for (size_t step = 1; step < result.path.size(); ++step) {
+        sf::Vector2i tile = result.path[step];
+        slackSeconds = min(slackSeconds, forecast.secondsUntilLava(tile.x, tile.y) - (step + 1) * secondsPerStep);
+    }
+    return finish(SearchFailure::None);
+}
@@ -0,0 +1,66 @@
+#include "ThreadPool.h"
+
+using namespace std;
+
+ThreadPool::ThreadPool(unsigned threadCount) {
+    if (threadCount == 0) threadCount = max(1u, thread::hardware_concurrency());
+    for (unsigned i = 1; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::run, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(jobMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+void ThreadPool::parallelFor(size_t count, const function<void(size_t, unsigned)>& fn) {
+    if (count == 0) return;
+    if (workers.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) fn(i, 0);
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(jobMutex);
+        job = &fn;
+        jobSize = count;
+        nextIndex = 0;
+        busy = static_cast<unsigned>(workers.size());
+        ++generation;
+    }
+    wake.notify_all();
+
+    work(0);
+
+    unique_lock<mutex> lock(jobMutex);
+    finished.wait(lock, [this] { return busy == 0; });
+    job = nullptr;
+}
+
+void ThreadPool::work(unsigned worker) {
+    for (size_t i = nextIndex++; i < jobSize; i = nextIndex++) {
+        (*job)(i, worker);
+    }
+}
+
+void ThreadPool::run(unsigned worker) {
+    unsigned seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> lock(jobMutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+
+        work(worker);
+
+        lock_guard<mutex> lock(jobMutex);
+        if (--busy == 0) finished.notify_one();
+    }
+}
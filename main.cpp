@@ -2,6 +2,8 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <iomanip>
+#include <chrono>
 #include <random>
 
 
@@ -13,6 +15,24 @@
 #include "UI-UX/UX.h"
 #include "UI-UX/GPS.h"
 #include "algorithms/Algorithms.h"
+#include "algorithms/Pathfinder.h"
+#include "algorithms/HierarchicalPathfinder.h"
+#include "algorithms/DStarLite.h"
+#include "algorithms/FlowField.h"
+#include "algorithms/Landmarks.h"
+#include "algorithms/ContractionHierarchy.h"
+#include "algorithms/Benchmark.h"
+#include "algorithms/Comparison.h"
+#include "algorithms/PathService.h"
+#include "algorithms/PathCache.h"
+#include "algorithms/Connectivity.h"
+#include "algorithms/SearchResult.h"
+#include "algorithms/AnytimeAStar.h"
+#include "algorithms/SlicedAStar.h"
+#include "algorithms/LavaForecast.h"
+#include "algorithms/SpaceTimeAStar.h"
+#include "algorithms/CooperativePlanner.h"
+#include "algorithms/FirstMoveTable.h"
 
 bool verifyPathSegments(const std::vector<sf::Vector2i>& path, const Map& map) {
     for (size_t i = 0; i + 1 < path.size(); ++i) {
@@ -24,7 +44,36 @@ bool verifyPathSegments(const std::vector<sf::Vector2i>& path, const Map& map) {
     return true;
 }
 
-int main() {
+// How a path service query is named in messages and coloured by the GPS
+std::string queryName(PathQuery query) {
+    switch (query) {
+        case PathQuery::Dijkstra: return "Dijkstra";
+        case PathQuery::AStar: return "A*";
+        case PathQuery::BidirectionalDijkstra: return "Bidirectional Dijkstra";
+        case PathQuery::BidirectionalAStar: return "Bidirectional A*";
+        case PathQuery::JPS: return "JPS";
+        case PathQuery::ALT: return "ALT A*";
+    }
+    return "";
+}
+
+AlgorithmType queryColour(PathQuery query) {
+    switch (query) {
+        case PathQuery::Dijkstra:
+        case PathQuery::BidirectionalDijkstra: return DIJKSTRA;
+        case PathQuery::JPS: return JPS;
+        case PathQuery::ALT: return ALT;
+        default: return ASTAR;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    // Searches are silent unless asked: --log-searches prints one report per query
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--log-searches") {
+            setSearchLog([](const std::string& line) { std::cout << line << '\n'; });
+        }
+    }
 
     sf::RenderWindow window(sf::VideoMode(1280, 720), "The Floor is Lava!!!");
     window.setFramerateLimit(60);
@@ -92,6 +141,43 @@ int main() {
 
     sf::Vector2i enteredPointB;
     GPS gps;
+    Pathfinder pathfinder;
+    HierarchicalPathfinder hpa;
+    HpaRoute hpaRoute; // refined a few segments ahead of the NaviGator
+    DStarLite dstar;   // replans incrementally while active
+    FlowField flowField;  // distances to the destination from every tile while active
+    sf::Vector2i flowFieldTile(-1, -1); // NaviGator tile the flow field path was last drawn from
+    Comparison comparison; // Compare mode searches running on worker threads
+    Contractions contractions; // CH built in the background on the first 9 press and after each regeneration
+    Landmarks landmarks; // ALT tables, rebuilt in the background after each regeneration
+    PathService pathService; // Dijkstra, A* and JPS run here so a long search never stalls a frame
+    unsigned pendingPath = 0; // handle of the query whose result will be shown, 0 if none
+    PathCache pathCache;      // finished searches, dropped when lava lands on their path
+    Connectivity connectivity; // which tiles can still reach each other, so walled-off goals skip the search
+    AnytimeAStar ara;          // improves its path a slice at a time while active
+    const std::chrono::microseconds araBudget(2000); // ARA* search time per frame
+    LavaForecast lavaForecast; // earliest time lava can reach each tile, kept up to date every tick
+    SpaceTimeAStar spaceTime;  // A* that stays ahead of the forecast lava
+    spaceTime.setTilesPerSecond(navigator.getTilesPerSecond());
+    SlicedAStar slicedSearch;  // A* spread over frames while searching
+    const std::chrono::microseconds sliceBudget(1000); // its search time per frame
+    CooperativePlanner crowdPlanner; // plans a crowd of NaviGators together so none of them collide
+    std::vector<Agent> crowd;
+    int crowdSteps = 0;           // steps the crowd took since its last planning round
+    float crowdTimer = 0.f;
+    const float crowdStepSeconds = 0.125f;
+    FirstMoves firstMoves; // first step to every tile from every tile, loaded or built the first time P is pressed
+
+    // Show a finished search (fresh or from the cache) on the GPS and in the message box
+    auto showPath = [&](PathQuery query, const std::vector<sf::Vector2i>& path, const std::string& detail) {
+        std::string name = queryName(query);
+        if (path.empty()) {
+            ux.setConfirmationMessage(name + " couldn't find a path! Try a different destination.");
+            return;
+        }
+        gps.setPath(path, queryColour(query));
+        ux.setConfirmationMessage(name + " path found with " + std::to_string(path.size()) + " steps (" + detail + ").");
+    };
     bool coordinatesReady = false;
 
     // Main game loop
@@ -105,15 +191,29 @@ int main() {
             if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Enter && ux.hasValidInput()) {
                 enteredPointB = ux.getTypedCoordinates();
                 coordinatesReady = true;
+                pathService.cancel(pendingPath); // a new destination supersedes the running search
+                pendingPath = 0;
 
-                // Check if destination is on lava
-                if (gameMap.isLava(enteredPointB.x, enteredPointB.y)) {
+                // Check if destination is off the map or on lava
+                if (enteredPointB.x < 0 || enteredPointB.y < 0
+                    || enteredPointB.x >= gameMap.getWidth() || enteredPointB.y >= gameMap.getHeight()) {
+                    std::stringstream ss;
+                    ss << "That destination is off the map! Pick x from 0 to " << gameMap.getWidth() - 1
+                       << " and y from 0 to " << gameMap.getHeight() - 1 << ".";
+                    ux.setConfirmationMessage(ss.str());
+                    coordinatesReady = false;
+                } else if (gameMap.isLava(enteredPointB.x, enteredPointB.y)) {
                     ux.setConfirmationMessage("That destination is on lava! Try a different location.");
                     coordinatesReady = false;
                 } else {
                     std::stringstream ss;
-                    ss << "Destination set to (" << enteredPointB.x << ", " << enteredPointB.y << ")\n";
-                    ss << "Press 1 for Dijkstra, 2 for A*, 3 to compare both";
+                    ss << "Destination set to (" << enteredPointB.x << ", " << enteredPointB.y << ")";
+                    lavaForecast.sync(gameMap);
+                    if (!lavaForecast.isSafeFor(enteredPointB, 30.f)) {
+                        ss << " - careful, lava could reach it in " << static_cast<int>(lavaForecast.secondsUntilLava(enteredPointB.x, enteredPointB.y)) << " s";
+                    }
+                    ss << "\n";
+                    ss << "Press 1 for Dijkstra, 2 for A* (hold Shift to search from both ends), 3 to compare both,\n4 for JPS, 5 for JPS+, 6 for HPA*, 7 for D* Lite (follows you and the lava),\n8 for A* with landmarks (ALT), 9 for CH, 0 for a flow field (re-routes instantly as you walk),\nQ for anytime A* (a quick path that improves over the next frames), T for A* spread over frames,\nF for A* that stays ahead of the lava forecast, P for a precomputed first-move table (no search)";
                     ux.setConfirmationMessage(ss.str());
                 }
 
@@ -127,7 +227,18 @@ int main() {
                 ux.setInstructionMessage("Re-enter coordinates and press Enter");
                 ux.setSecondaryMessage("Click the box below and type a destination");
                 ux.clearConfirmationMessage();
+                ux.clearSearchStats();
                 gps.clearPath();
+                hpaRoute = HpaRoute();
+                dstar.clear();
+                flowField.clear();
+                ara.clear();
+                slicedSearch.cancel();
+                crowd.clear();
+                gps.setAgents({});
+                comparison.discard();
+                pathService.cancelAll();
+                pendingPath = 0;
             }
 
             // Regenerate lava with G key
@@ -139,6 +250,57 @@ int main() {
                 ux.setConfirmationMessage("Lava regenerated with new seed: " + std::to_string(seed));
             }
 
+            // Spawn a crowd of NaviGators around this one with M, or send it away again
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::M) {
+                if (!crowd.empty()) {
+                    crowd.clear();
+                    gps.setAgents({});
+                    ux.setConfirmationMessage("Crowd dismissed.");
+                } else {
+                    // Random walkable starts and goals within 40 tiles; no two agents share a start or a goal
+                    sf::Vector2i here = gameMap.screenToTile(navigator.getPosition().x, navigator.getPosition().y);
+                    std::uniform_int_distribution<int> offset(-40, 40);
+                    pathfinder.sync(gameMap);
+                    const SearchGrid& grid = pathfinder.getGrid();
+                    std::vector<unsigned char> startTaken(grid.tileCount(), 0);
+                    std::vector<unsigned char> goalTaken(startTaken.size(), 0);
+                    auto pick = [&](std::vector<unsigned char>& taken) {
+                        for (int attempt = 0; attempt < 50; ++attempt) {
+                            sf::Vector2i tile(here.x + offset(rng), here.y + offset(rng));
+                            if (!grid.isWalkable(tile)) continue;
+                            unsigned char& used = taken[grid.index(tile)];
+                            if (used) continue;
+                            used = 1;
+                            return tile;
+                        }
+                        return sf::Vector2i(-1, -1);
+                    };
+                    for (int i = 0; i < 300; ++i) {
+                        Agent agent;
+                        agent.position = pick(startTaken);
+                        agent.goal = pick(goalTaken);
+                        if (agent.position.x < 0 || agent.goal.x < 0) continue;
+                        crowd.push_back(agent);
+                    }
+                    crowdPlanner.reset();
+                    PlanningStats planning = crowdPlanner.planRound(grid, landmarks.get().get(), crowd);
+                    crowdSteps = 0;
+                    crowdTimer = 0.f;
+                    std::stringstream ss;
+                    ss << "Cooperative A*: " << planning.agents << " NaviGators planned in " << std::fixed << std::setprecision(1)
+                       << planning.wallMs << " ms on " << crowdPlanner.getThreadCount() << " threads (" << planning.waves << " waves, "
+                       << planning.waiting << " waiting). Press M again to dismiss them.";
+                    ux.setConfirmationMessage(ss.str());
+                }
+            }
+
+            // Benchmark the pathfinders on the current map with B, parallel A* on a much bigger one with Shift+B
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::B) {
+                ux.setConfirmationMessage("Benchmarking pathfinders... see console for results.");
+                if (event.key.shift) runParallelSearchBenchmark();
+                else runPathBenchmark(gameMap, 20, 77, firstMoves.get().get());
+            }
+
             // Zoom control
             if (event.type == sf::Event::MouseWheelScrolled) {
                 if (event.mouseWheelScroll.delta > 0)
@@ -160,40 +322,215 @@ int main() {
                     continue;
                 }
 
-                if (event.key.code == sf::Keyboard::Num1) {
-                    auto path = findDijkstraPath(gameMap, pointA, enteredPointB);
+                // Picking any mode replaces the HPA* route being refined and stops D* Lite
+                if ((event.key.code >= sf::Keyboard::Num0 && event.key.code <= sf::Keyboard::Num9)
+                    || event.key.code == sf::Keyboard::Q || event.key.code == sf::Keyboard::T
+                    || event.key.code == sf::Keyboard::F || event.key.code == sf::Keyboard::P) {
+                    hpaRoute = HpaRoute();
+                    dstar.clear();
+                    flowField.clear();
+                    ara.clear();
+                    slicedSearch.cancel();
+                    if (event.key.code != sf::Keyboard::Num3) comparison.discard();
+                    pathService.cancel(pendingPath);
+                    pendingPath = 0;
+                    ux.clearSearchStats();
+
+                    // Lava has walled the destination off: every mode would flood our side and fail
+                    connectivity.sync(gameMap);
+                    if (!connectivity.connected(pointA, enteredPointB)) {
+                        gps.clearPath();
+                        ux.setConfirmationMessage("Lava has cut you off from the destination! Press R to pick a new one.");
+                        continue;
+                    }
+                }
+
+                if (event.key.code == sf::Keyboard::Num1 || event.key.code == sf::Keyboard::Num2
+                    || event.key.code == sf::Keyboard::Num4) {
+                    // Shift+1 / Shift+2 search from both ends
+                    PathQuery query = PathQuery::JPS;
+                    if (event.key.code == sf::Keyboard::Num1) {
+                        query = event.key.shift ? PathQuery::BidirectionalDijkstra : PathQuery::Dijkstra;
+                    } else if (event.key.code == sf::Keyboard::Num2) {
+                        query = event.key.shift ? PathQuery::BidirectionalAStar : PathQuery::AStar;
+                    }
+                    if (const CachedPath* cached = pathCache.find(pointA, enteredPointB, query)) {
+                        showPath(query, cached->path, "cached, " + pathCache.report());
+                    } else {
+                        pathfinder.sync(gameMap);
+                        pendingPath = pathService.submit(query, pathfinder.getGrid(), pointA, enteredPointB);
+                        ux.setConfirmationMessage(queryName(query) + " is searching...");
+                    }
+                }
+                else if (event.key.code == sf::Keyboard::Num8) {
+                    if (const CachedPath* cached = pathCache.find(pointA, enteredPointB, PathQuery::ALT)) {
+                        showPath(PathQuery::ALT, cached->path, "cached, " + pathCache.report());
+                    } else if (!landmarks.get()) {
+                        ux.setConfirmationMessage("Landmarks are still being measured for this lava. Try again in a moment.");
+                    } else {
+                        pathfinder.sync(gameMap);
+                        pendingPath = pathService.submit(PathQuery::ALT, pathfinder.getGrid(), pointA, enteredPointB,
+                                                         std::chrono::milliseconds(2000), landmarks.get());
+                        ux.setConfirmationMessage(queryName(PathQuery::ALT) + " is searching...");
+                    }
+                }
+                else if (event.key.code == sf::Keyboard::Num9) {
+                    contractions.sync(gameMap);
+                    if (!contractions.request()) {
+                        ux.setConfirmationMessage("Building the contraction hierarchy in the background...\n"
+                                                  "Press 9 again once it's ready.");
+                        continue;
+                    }
+                    ContractionHierarchy& hierarchy = *contractions.get();
+                    // Catches up with the spread first, re-weighting only the arcs through newly closed tiles
+                    sf::Clock searchClock;
+                    auto path = hierarchy.findPath(gameMap, pointA, enteredPointB);
+                    float searchMs = searchClock.getElapsedTime().asMicroseconds() / 1000.f;
 
                     if (path.empty()) {
-                        ux.setConfirmationMessage("Dijkstra couldn't find a path! Try a different destination.");
+                        ux.setConfirmationMessage("CH couldn't find a path! Try a different destination.");
                     } else {
-                        gps.setPath(path, DIJKSTRA);
-                        ux.setConfirmationMessage("Dijkstra path found with " + std::to_string(path.size()) + " steps.");
+                        gps.setPath(path, CH);
+                        std::stringstream ss;
+                        ss << "CH path found with " << path.size() << " steps (" << hierarchy.getNodesExplored()
+                           << " tiles scanned, " << hierarchy.getArcsUpdated() << " arcs customized, " << searchMs << " ms).";
+                        ux.setConfirmationMessage(ss.str());
                     }
                 }
-                else if (event.key.code == sf::Keyboard::Num2) {
-                    auto path = findAStarPath(gameMap, pointA, enteredPointB);
+                else if (event.key.code == sf::Keyboard::Num5) {
+                    auto path = pathfinder.findJPSPlusPath(gameMap, pointA, enteredPointB);
 
+                    const SearchStats& stats = pathfinder.getLastStats();
+                    ux.setSearchStats("JPS+: " + describeSearch(stats));
                     if (path.empty()) {
-                        ux.setConfirmationMessage("A* couldn't find a path! Try a different destination.");
+                        ux.setConfirmationMessage("JPS+: " + failureText(stats.failure) + "! Try a different destination.");
                     } else {
-                        gps.setPath(path, ASTAR);
-                        ux.setConfirmationMessage("A* path found with " + std::to_string(path.size()) + " steps.");
+                        gps.setPath(path, JPS_PLUS);
+                        ux.setConfirmationMessage("JPS+ path found with " + std::to_string(path.size()) + " steps.");
                     }
                 }
-                else if (event.key.code == sf::Keyboard::Num3) {
-                    auto pathD = findDijkstraPath(gameMap, pointA, enteredPointB);
-                    auto pathA = findAStarPath(gameMap, pointA, enteredPointB);
+                else if (event.key.code == sf::Keyboard::Num6) {
+                    if (!hpa.findRoute(gameMap, pointA, enteredPointB, hpaRoute)) {
+                        ux.setConfirmationMessage("HPA* couldn't find a path! Try a different destination.");
+                    } else {
+                        hpa.refine(hpaRoute, 2);
+                        gps.setPath(hpaRoute.preview(), HPA);
+                        ux.setConfirmationMessage("HPA* route found with " + std::to_string(hpaRoute.length) + " steps ("
+                                                  + std::to_string(hpa.getNodesExplored()) + " of "
+                                                  + std::to_string(hpa.getNodeCount()) + " entrances explored).");
+                    }
+                }
+                else if (event.key.code == sf::Keyboard::Num7) {
+                    dstar.setGoal(gameMap, pointA, enteredPointB);
+                    dstar.replan();
+                    auto path = dstar.getPath();
 
-                    if (pathD.empty() && pathA.empty()) {
-                        ux.setConfirmationMessage("Neither algorithm could find a path! Try a different destination.");
+                    if (path.empty()) {
+                        dstar.clear();
+                        ux.setConfirmationMessage("D* Lite couldn't find a path! Try a different destination.");
                     } else {
-                        gps.setComparisonPaths(pathD, pathA);
+                        gps.setPath(path, DSTAR_LITE);
+                        ux.setConfirmationMessage("D* Lite path found with " + std::to_string(path.size()) + " steps ("
+                                                  + std::to_string(dstar.getNodesExpanded()) + " nodes explored).\n"
+                                                  + "It will replan as you walk and the lava spreads.");
+                    }
+                }
+                else if (event.key.code == sf::Keyboard::Num0) {
+                    // One backward search from the destination; every later re-route is a walk down the field
+                    flowField.setGoal(gameMap, enteredPointB);
+                    auto path = flowField.pathFrom(pointA);
 
+                    if (path.empty()) {
+                        flowField.clear();
+                        ux.setConfirmationMessage("The flow field can't reach you! Try a different destination.");
+                    } else {
+                        flowFieldTile = pointA;
+                        gps.setPath(path, FLOW_FIELD);
+                        ux.setConfirmationMessage("Flow field built over " + std::to_string(flowField.getTilesUpdated())
+                                                  + " tiles, path has " + std::to_string(path.size()) + " steps.\n"
+                                                  + "It will re-route as you walk and the lava spreads.");
+                    }
+                }
+                else if (event.key.code == sf::Keyboard::Q) {
+                    // Searched a slice per frame below; each better path is shown as it's found
+                    ara.plan(gameMap, pointA, enteredPointB);
+                    ux.setConfirmationMessage("ARA* is searching...");
+                }
+                else if (event.key.code == sf::Keyboard::F) {
+                    // Routes only through tiles the NaviGator can walk off before lava could reach them
+                    lavaForecast.sync(gameMap);
+                    SearchResult result = spaceTime.findPath(lavaForecast, pointA, enteredPointB, std::chrono::milliseconds(12));
+                    ux.setSearchStats("Space-time A*: " + describeSearch(result.stats) + "\n"
+                                      + std::to_string(spaceTime.getLavaPruned()) + " moves refused for lava");
+                    if (!result.found()) {
+                        ux.setConfirmationMessage("Space-time A*: " + failureText(result.stats.failure) + " before the lava! Try a different destination.");
+                    } else {
+                        gps.setPath(result.path, SPACE_TIME);
+                        std::stringstream ss;
+                        ss << "Space-time A* path found with " << result.path.size() << " steps";
+                        if (spaceTime.getSlackSeconds() < 1000.f) {
+                            ss << ", staying at least " << std::fixed << std::setprecision(1) << spaceTime.getSlackSeconds() << " s ahead of the lava.";
+                        } else {
+                            ss << "; lava can't reach any of it.";
+                        }
+                        ux.setConfirmationMessage(ss.str());
+                    }
+                }
+                else if (event.key.code == sf::Keyboard::P) {
+                    // Built once per lava layout on every core and saved next to the map, then a path is only lookups
+                    pathfinder.sync(gameMap);
+                    firstMoves.sync(gameMap);
+                    if (!firstMoves.request("maps/floorIsLava.cpd")) {
+                        ux.setConfirmationMessage("Building the first-move table on every core, this takes a few minutes...\n"
+                                                  "Press P again once it's ready.");
+                        continue;
+                    }
+                    SearchResult result = firstMoves.get()->findPath(pathfinder.getGrid(), pointA, enteredPointB);
+                    ux.setSearchStats("First-move table: " + describeSearch(result.stats));
+                    if (result.found()) {
+                        gps.setPath(result.path, FIRST_MOVE);
                         std::stringstream ss;
-                        ss << "Dijkstra: " << pathD.size() << " steps, A*: " << pathA.size() << " steps";
-                        if (pathD.empty()) ss << " (Dijkstra failed)";
-                        if (pathA.empty()) ss << " (A* failed)";
+                        ss << "First-move table path found with " << result.path.size() << " steps in "
+                           << std::fixed << std::setprecision(3) << result.stats.wallMs << " ms, without searching.";
                         ux.setConfirmationMessage(ss.str());
+                    } else if (result.stats.failure == SearchFailure::Outdated) {
+                        // Lava spread over the stored route since the table was built; search the current map instead
+                        pendingPath = pathService.submit(PathQuery::AStar, pathfinder.getGrid(), pointA, enteredPointB);
+                        ux.setConfirmationMessage("Lava has spread over the table's route, searching with A* instead...");
+                    } else {
+                        ux.setConfirmationMessage("First-move table: " + failureText(result.stats.failure) + "! Try a different destination.");
+                    }
+                }
+                else if (event.key.code == sf::Keyboard::T) {
+                    // Stepped a slice per frame below, so the frame rate holds however long it takes
+                    if (slicedSearch.begin(gameMap, pointA, enteredPointB)) {
+                        gps.setSearching({pointA}, enteredPointB);
+                        ux.setConfirmationMessage("Time-sliced A* is searching...");
+                    } else {
+                        ux.setConfirmationMessage("Time-sliced A*: " + failureText(slicedSearch.getStats().failure) + "! Try a different destination.");
+                    }
+                }
+                else if (event.key.code == sf::Keyboard::Num3) {
+                    // Both paths cached: no search at all
+                    const CachedPath* cachedD = nullptr;
+                    const CachedPath* cachedA = nullptr;
+                    pathCache.findPair(pointA, enteredPointB, PathQuery::Dijkstra, PathQuery::AStar, cachedD, cachedA);
+                    if (cachedD && cachedA) {
+                        gps.setComparisonPaths(cachedD->path, cachedA->path);
+                        std::stringstream ss;
+                        ss << "Dijkstra: " << cachedD->path.size() << " steps (" << cachedD->nodesExplored << " nodes), A*: "
+                           << cachedA->path.size() << " steps (" << cachedA->nodesExplored << " nodes), "
+                           << pathCache.report();
+                        ux.setConfirmationMessage(ss.str());
+                    } else {
+                        // Search a snapshot of this frame's grid; the results are picked up below once ready
+                        pathfinder.sync(gameMap);
+                        auto snapshot = std::make_shared<const SearchGrid>(pathfinder.getGrid());
+                        if (comparison.start(snapshot, pointA, enteredPointB)) {
+                            ux.setConfirmationMessage("Comparing Dijkstra and A*...");
+                        } else {
+                            ux.setConfirmationMessage("Still comparing! Wait for the current comparison to finish.");
+                        }
                     }
                 }
             }
@@ -206,6 +543,178 @@ int main() {
         navigator.handleInput(frameTime, sf::Event(), view);
         navigator.update(frameTime);
         gameMap.updateLavaSpread(frameTime.asSeconds());
+        pathfinder.sync(gameMap); // patch the jump tables with this tick's lava
+        hpa.sync(gameMap);        // rebuild only the clusters the lava touched
+        landmarks.sync(gameMap);  // starts a background rebuild after G, picks up finished ones
+        pathCache.sync(gameMap);  // forget paths this tick's lava landed on
+        connectivity.sync(gameMap); // split off any region this tick's lava walled in
+        lavaForecast.sync(gameMap);  // lower the arrival times around this tick's lava
+        firstMoves.sync(gameMap);    // drops the table after G, picks up a finished build
+        contractions.sync(gameMap);  // re-customizes in the background after G, picks up finished builds
+        if (contractions.takeFinished()) {
+            std::stringstream ss;
+            ss << "Contraction hierarchy ready (" << contractions.get()->getArcCount() << " arcs). Press 9 to use it.";
+            ux.setConfirmationMessage(ss.str());
+        }
+        if (firstMoves.takeFinished()) {
+            std::stringstream ss;
+            ss << "First-move table ready (" << firstMoves.get()->runs.size() << " runs, " << std::fixed << std::setprecision(1)
+               << firstMoves.get()->bytes() / 1048576.0 << " MB, built in " << firstMoves.get()->buildMs / 1000.0 << " s). Press P to use it.";
+            ux.setConfirmationMessage(ss.str());
+        }
+
+        // Show the path service result the player is waiting for; older ones were superseded
+        PathResult found;
+        while (pathService.poll(found)) {
+            if (found.status == PathStatus::Found || found.status == PathStatus::NoPath) {
+                pathCache.store(found.start, found.goal, found.query, found.layout, found.path, found.stats.expanded);
+            }
+            if (searchLogEnabled()) {
+                logSearch(queryName(found.query) + ": " + failureText(found.stats.failure) + "\n" + describeSearch(found.stats));
+            }
+            if (found.handle != pendingPath) continue;
+            pendingPath = 0;
+
+            if (found.status == PathStatus::TimedOut) {
+                ux.setConfirmationMessage(queryName(found.query) + " ran out of time! Try a closer destination.");
+            } else if (found.status != PathStatus::Cancelled) {
+                ux.setSearchStats(queryName(found.query) + ": " + describeSearch(found.stats));
+                if (found.path.empty()) {
+                    ux.setConfirmationMessage(queryName(found.query) + ": " + failureText(found.stats.failure) + "! Try a different destination.");
+                } else {
+                    showPath(found.query, found.path, std::to_string(found.stats.expanded) + " nodes explored");
+                }
+            }
+        }
+
+        // Show the Compare mode results once every worker has finished
+        ComparisonResult compared;
+        if (comparison.poll(compared)) {
+            pathCache.store(compared.start, compared.goal, PathQuery::Dijkstra, compared.layout,
+                            compared.dijkstraPath, compared.dijkstraStats.expanded);
+            pathCache.store(compared.start, compared.goal, PathQuery::AStar, compared.layout,
+                            compared.astarPath, compared.astarStats.expanded);
+
+            const auto& pathD = compared.dijkstraPath;
+            const auto& pathA = compared.astarPath;
+            if (pathD.empty() && pathA.empty()) {
+                ux.setConfirmationMessage("Neither algorithm could find a path! Try a different destination.");
+            } else {
+                gps.setComparisonPaths(pathD, pathA);
+
+                std::stringstream ss;
+                ss << "Dijkstra: " << pathD.size() << " steps (" << compared.dijkstraStats.expanded << " nodes), A*: "
+                   << pathA.size() << " steps (" << compared.astarStats.expanded << " nodes)";
+                if (pathD.empty()) ss << " (Dijkstra failed)";
+                if (pathA.empty()) ss << " (A* failed)";
+                ux.setConfirmationMessage(ss.str());
+                ux.setSearchStats("Dijkstra: " + describeSearch(compared.dijkstraStats) + "\nA*: " + describeSearch(compared.astarStats));
+            }
+        }
+
+        // Repair the D* Lite plan for this tick's lava and the NaviGator's new tile
+        if (dstar.isActive()) {
+            dstar.sync(gameMap);
+            dstar.moveStart(gameMap.screenToTile(navigator.getPosition().x, navigator.getPosition().y));
+            if (dstar.replan()) {
+                auto path = dstar.getPath();
+                if (!path.empty()) {
+                    gps.setPath(path, DSTAR_LITE);
+                } else if (!dstar.isActive()) {
+                    ux.setConfirmationMessage("Lava swallowed the destination! Press R to pick a new one.");
+                }
+            }
+        }
+
+        // Give ARA* this frame's slice; it starts over if lava lands on its path
+        if (ara.isActive()) {
+            if (ara.sync(gameMap, gameMap.screenToTile(navigator.getPosition().x, navigator.getPosition().y))) {
+                ux.setConfirmationMessage("Lava hit the ARA* path! Searching again...");
+            }
+            if (ara.step(araBudget)) {
+                gps.setPath(ara.getPath(), ARA);
+                std::stringstream ss;
+                ss << "ARA* path found with " << ara.getPath().size() << " steps, ";
+                if (ara.getBound() <= 1.0) {
+                    ss << "and it is the shortest.";
+                } else {
+                    ss << "at most " << std::fixed << std::setprecision(2) << ara.getBound() << "x the shortest.\nImproving...";
+                }
+                ux.setConfirmationMessage(ss.str());
+                ux.setSearchStats("ARA*: " + describeSearch(ara.getStats()));
+            } else if (ara.isFinished() && ara.getPath().empty()) {
+                ux.setConfirmationMessage("ARA*: " + failureText(ara.getStats().failure) + "! Try a different destination.");
+                ux.setSearchStats("ARA*: " + describeSearch(ara.getStats()));
+                ara.clear();
+            }
+        }
+
+        // Give the time-sliced A* this frame's slice and show how far it has got
+        if (slicedSearch.isSearching()) {
+            slicedSearch.sync(gameMap, gameMap.screenToTile(navigator.getPosition().x, navigator.getPosition().y));
+            bool over = !slicedSearch.isSearching() || slicedSearch.step(sliceBudget);
+            const SearchStats& stats = slicedSearch.getStats();
+            if (!over) {
+                gps.setSearching(slicedSearch.getProbe(), slicedSearch.getGoal());
+                ux.setConfirmationMessage("Time-sliced A* is searching... " + std::to_string(static_cast<int>(slicedSearch.getProgress() * 100))
+                                          + "% of the way (" + std::to_string(slicedSearch.getSlices()) + " frames)");
+            } else if (slicedSearch.getPath().empty()) {
+                gps.clearPath();
+                ux.setConfirmationMessage("Time-sliced A*: " + failureText(stats.failure) + "! Try a different destination.");
+                ux.setSearchStats("Time-sliced A*: " + describeSearch(stats));
+            } else {
+                gps.setPath(slicedSearch.getPath(), ASTAR);
+                ux.setConfirmationMessage("Time-sliced A* path found with " + std::to_string(slicedSearch.getPath().size())
+                                          + " steps over " + std::to_string(slicedSearch.getSlices()) + " frames.");
+                ux.setSearchStats("Time-sliced A*: " + describeSearch(stats));
+            }
+        }
+
+        // Follow the flow field from the NaviGator's tile; lava only repairs the tiles it cut off
+        if (flowField.isActive()) {
+            bool fieldChanged = flowField.sync(gameMap);
+            sf::Vector2i here = gameMap.screenToTile(navigator.getPosition().x, navigator.getPosition().y);
+            if (fieldChanged || here != flowFieldTile) {
+                flowFieldTile = here;
+                auto path = flowField.pathFrom(here);
+                if (!path.empty()) {
+                    gps.setPath(path, FLOW_FIELD);
+                } else if (!flowField.isActive()) {
+                    ux.setConfirmationMessage("Lava swallowed the destination! Press R to pick a new one.");
+                }
+            }
+        }
+
+        // Refine the HPA* route once the NaviGator gets close to the end of the refined part
+        if (!hpaRoute.empty() && !hpaRoute.isComplete()) {
+            sf::Vector2i here = gameMap.screenToTile(navigator.getPosition().x, navigator.getPosition().y);
+            sf::Vector2i refinedEnd = hpaRoute.tiles.back();
+            if (abs(here.x - refinedEnd.x) + abs(here.y - refinedEnd.y) < 32) {
+                if (hpa.refine(hpaRoute, 1)) {
+                    gps.setPath(hpaRoute.preview(), HPA);
+                } else {
+                    hpaRoute = HpaRoute();
+                    ux.setConfirmationMessage("Lava cut the HPA* route! Press 6 to plan again.");
+                }
+            }
+        }
+
+        // Walk the crowd one reserved step at a time and replan halfway through each window
+        if (!crowd.empty()) {
+            crowdTimer += frameTime.asSeconds();
+            while (crowdTimer >= crowdStepSeconds) {
+                crowdTimer -= crowdStepSeconds;
+                crowdPlanner.advance(crowd, 1);
+                if (++crowdSteps >= crowdPlanner.getWindow() / 2) {
+                    crowdPlanner.planRound(pathfinder.getGrid(), landmarks.get().get(), crowd);
+                    crowdSteps = 0;
+                }
+            }
+            std::vector<sf::Vector2i> positions;
+            positions.reserve(crowd.size());
+            for (const Agent& agent : crowd) positions.push_back(agent.position);
+            gps.setAgents(positions);
+        }
 
         gps.update(frameTime.asSeconds());
         view.setCenter(navigator.getPosition());